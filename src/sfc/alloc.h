@@ -1,6 +1,7 @@
 #pragma once
 
 #include "sfc/alloc/alloc.h"
+#include "sfc/alloc/arena.h"
 #include "sfc/alloc/boxed.h"
 #include "sfc/alloc/list.h"
 #include "sfc/alloc/string.h"
@@ -0,0 +1,185 @@
+#include "sfc/alloc/arena.h"
+
+namespace sfc::alloc {
+
+Arena::Arena() noexcept = default;
+
+Arena::~Arena() noexcept {
+  this->reset();
+  for (const auto& chunk : _chunks.as_slice()) {
+    Global::deallocate(chunk.ptr, mem::Layout::array<u8>(chunk.size));
+  }
+}
+
+Arena::Arena(Arena&& other) noexcept
+    : _chunk_size{other._chunk_size},
+      _chunks{mem::move(other._chunks)},
+      _large{mem::move(other._large)},
+      _used{mem::take(other._used)},
+      _pos{mem::take(other._pos)},
+      _end{mem::take(other._end)} {}
+
+Arena& Arena::operator=(Arena&& other) noexcept {
+  if (this != &other) {
+    mem::swap(_chunk_size, other._chunk_size);
+    mem::swap(_chunks, other._chunks);
+    mem::swap(_large, other._large);
+    mem::swap(_used, other._used);
+    mem::swap(_pos, other._pos);
+    mem::swap(_end, other._end);
+  }
+  return *this;
+}
+
+auto Arena::with_chunk_size(usize chunk_size) -> Arena {
+  auto res = Arena{};
+  res._chunk_size = chunk_size;
+  return res;
+}
+
+auto Arena::allocate(mem::Layout layout) -> void* {
+  if (layout.size == 0) {
+    return nullptr;
+  }
+  if (layout.size > _chunk_size / 4) {
+    return this->alloc_large(layout);
+  }
+
+  auto pos = num::align_up(reinterpret_cast<usize>(_pos), layout.align);
+  if (_pos == nullptr || pos + layout.size > reinterpret_cast<usize>(_end)) {
+    if (!this->next_chunk(layout.size + layout.align)) {
+      return nullptr;
+    }
+    pos = num::align_up(reinterpret_cast<usize>(_pos), layout.align);
+  }
+  _pos = reinterpret_cast<u8*>(pos + layout.size);
+  return reinterpret_cast<void*>(pos);
+}
+
+auto Arena::allocate_zeroed(mem::Layout layout) -> void* {
+  const auto p = this->allocate(layout);
+  if (p) {
+    ptr::write_bytes(ptr::cast<u8>(p), 0, layout.size);
+  }
+  return p;
+}
+
+void Arena::deallocate(void* ptr, mem::Layout layout) {
+  if (ptr == nullptr) {
+    return;
+  }
+
+  // only the most recent allocation can be taken back
+  if (!_large.is_empty() && _large[_large.len() - 1].ptr == ptr) {
+    const auto large = _large.pop().unwrap();
+    Global::deallocate(large.ptr, large.layout);
+    return;
+  }
+  if (ptr::cast<u8>(ptr) + layout.size == _pos) {
+    _pos = ptr::cast<u8>(ptr);
+  }
+}
+
+auto Arena::grow(void* ptr, mem::Layout layout, usize new_size) -> void* {
+  if (layout.size >= new_size) {
+    return ptr;
+  }
+  if (ptr == nullptr || layout.size == 0) {
+    return this->allocate({new_size, layout.align});
+  }
+
+  // the most recent allocation grows in place, while it fits
+  if (!_large.is_empty() && _large[_large.len() - 1].ptr == ptr) {
+    auto& large = _large[_large.len() - 1];
+    const auto res = Global::grow(ptr, large.layout, new_size);
+    if (res != nullptr) {
+      large = Large{res, {new_size, large.layout.align}};
+    }
+    return res;
+  }
+  if (ptr::cast<u8>(ptr) + layout.size == _pos && ptr::cast<u8>(ptr) + new_size <= _end) {
+    _pos = ptr::cast<u8>(ptr) + new_size;
+    return ptr;
+  }
+
+  const auto res = this->allocate({new_size, layout.align});
+  if (res != nullptr) {
+    ptr::copy_nonoverlapping(ptr::cast<u8>(ptr), ptr::cast<u8>(res), layout.size);
+  }
+  return res;
+}
+
+auto Arena::shrink(void* ptr, mem::Layout layout, usize new_size) -> void* {
+  if (layout.size <= new_size) {
+    return ptr;
+  }
+  if (new_size == 0) {
+    this->deallocate(ptr, layout);
+    return nullptr;
+  }
+
+  if (ptr::cast<u8>(ptr) + layout.size == _pos) {
+    _pos = ptr::cast<u8>(ptr) + new_size;
+  }
+  return ptr;
+}
+
+void Arena::reset() {
+  this->rewind(Checkpoint{0, 0, nullptr});
+}
+
+auto Arena::checkpoint() const noexcept -> Checkpoint {
+  return Checkpoint{_used, _large.len(), _pos};
+}
+
+void Arena::rewind(const Checkpoint& mark) {
+  while (_large.len() > mark.large) {
+    const auto large = _large.pop().unwrap();
+    Global::deallocate(large.ptr, large.layout);
+  }
+
+  _used = mark.used;
+  _pos = mark.pos;
+  _end = _used == 0 ? nullptr : _chunks[_used - 1].ptr + _chunks[_used - 1].size;
+}
+
+auto Arena::allocated_bytes() const noexcept -> usize {
+  auto res = 0UL;
+  for (const auto& chunk : _chunks.as_slice()) {
+    res += chunk.size;
+  }
+  for (const auto& large : _large.as_slice()) {
+    res += large.layout.size;
+  }
+  return res;
+}
+
+auto Arena::alloc_large(mem::Layout layout) -> void* {
+  const auto res = Global::allocate(layout);
+  if (res != nullptr) {
+    _large.push(Large{res, layout});
+  }
+  return res;
+}
+
+// moves on to the next chunk kept from before a reset, or to a new one
+auto Arena::next_chunk(usize min_size) -> bool {
+  if (_used < _chunks.len() && _chunks[_used].size >= min_size) {
+    _used += 1;
+  } else {
+    const auto size = cmp::max(_chunk_size, min_size);
+    const auto ptr = Global::allocate(mem::Layout::array<u8>(size));
+    if (ptr == nullptr) {
+      return false;
+    }
+    _chunks.insert(_used, Chunk{ptr::cast<u8>(ptr), size});
+    _used += 1;
+  }
+
+  const auto& chunk = _chunks[_used - 1];
+  _pos = chunk.ptr;
+  _end = chunk.ptr + chunk.size;
+  return true;
+}
+
+}  // namespace sfc::alloc
@@ -0,0 +1,106 @@
+#include "sfc/alloc/arena.h"
+#include "sfc/collections/queue.h"
+#include "sfc/test/test.h"
+
+namespace sfc::alloc::test {
+
+SFC_TEST(arena_alloc) {
+  auto arena = Arena{};
+  sfc::assert_eq(arena.allocate({0, 1}), nullptr);
+  sfc::assert_eq(arena.allocated_bytes(), 0U);
+
+  const auto a = arena.allocate({3, 1});
+  const auto b = arena.allocate({8, 8});
+  sfc::assert_ne(a, nullptr);
+  sfc::assert_eq(reinterpret_cast<usize>(b) % 8, 0U);
+  sfc::assert_eq(ptr::cast<u8>(b) >= ptr::cast<u8>(a) + 3, true);
+  sfc::assert_eq(arena.allocated_bytes(), 4096U);
+
+  // the most recent allocation grows and shrinks in place
+  const auto c = arena.grow(b, {8, 8}, 64);
+  sfc::assert_eq(c, b);
+  sfc::assert_eq(arena.shrink(c, {64, 8}, 16), c);
+  arena.deallocate(c, {16, 8});
+  sfc::assert_eq(arena.allocate({8, 8}), b);
+
+  const auto z = ptr::cast<u8>(arena.allocate_zeroed({100, 1}));
+  for (auto i = 0U; i < 100U; ++i) {
+    sfc::assert_eq(z[i], 0U);
+  }
+}
+
+SFC_TEST(arena_large) {
+  auto arena = Arena::with_chunk_size(1024);
+
+  // past a quarter of a chunk, an allocation gets a block of its own
+  const auto a = ptr::cast<u8>(arena.allocate({1000, 1}));
+  ptr::write_bytes(a, 7, 1000);
+  const auto b = ptr::cast<u8>(arena.grow(a, {1000, 1}, 5000));
+  sfc::assert_eq(b[999], 7U);
+  sfc::assert_eq(arena.allocated_bytes(), 5000U);
+
+  arena.deallocate(b, {5000, 1});
+  sfc::assert_eq(arena.allocated_bytes(), 0U);
+}
+
+SFC_TEST(arena_reset) {
+  auto arena = Arena::with_chunk_size(256);
+  for (auto i = 0U; i < 100U; ++i) {
+    (void)arena.allocate({32, 8});
+  }
+  (void)arena.allocate({4096, 8});
+  const auto bytes = arena.allocated_bytes();
+  sfc::assert_eq(bytes >= 3200U + 4096U, true);
+
+  // chunks are kept for the next round, dedicated blocks are not
+  arena.reset();
+  sfc::assert_eq(arena.allocated_bytes(), bytes - 4096U);
+  for (auto i = 0U; i < 100U; ++i) {
+    (void)arena.allocate({32, 8});
+  }
+  sfc::assert_eq(arena.allocated_bytes(), bytes - 4096U);
+}
+
+SFC_TEST(arena_checkpoint) {
+  auto arena = Arena::with_chunk_size(256);
+  const auto a = arena.allocate({16, 8});
+
+  const auto mark = arena.checkpoint();
+  for (auto i = 0U; i < 50U; ++i) {
+    (void)arena.allocate({24, 8});
+  }
+  (void)arena.allocate({1024, 8});
+  arena.rewind(mark);
+
+  const auto b = arena.allocate({16, 8});
+  sfc::assert_eq(ptr::cast<u8>(b), ptr::cast<u8>(a) + 16);
+
+  {
+    const auto scope = ArenaScope{arena};
+    (void)arena.allocate({64, 8});
+  }
+  sfc::assert_eq(ptr::cast<u8>(arena.allocate({16, 8})), ptr::cast<u8>(b) + 16);
+}
+
+SFC_TEST(arena_list) {
+  auto arena = Arena{};
+  {
+    auto v = List<u32, ArenaRef>::with_capacity(0, arena);
+    for (auto i = 0U; i < 10000U; ++i) {
+      v.push(i);
+    }
+    sfc::assert_eq(v.len(), 10000U);
+    sfc::assert_eq(v[9999], 9999U);
+
+    auto q = collections::Queue<u64, ArenaRef>::with_capacity(4, arena);
+    for (auto i = 0U; i < 100U; ++i) {
+      q.push(i);
+    }
+    sfc::assert_eq(q.pop(), Option{0UL});
+    sfc::assert_eq(q.len(), 99U);
+  }
+  arena.reset();
+  sfc::assert_eq(arena.allocate({16, 8}) != nullptr, true);
+}
+
+}  // namespace sfc::alloc::test
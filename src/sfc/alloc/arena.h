@@ -0,0 +1,117 @@
+#pragma once
+
+#include "sfc/alloc/list.h"
+
+namespace sfc::alloc {
+
+class ArenaRef;
+
+// A bump allocator over a list of chunks. Freeing one allocation is a no-op (unless it is the
+// most recent); memory comes back all at once with `reset`, or past a checkpoint with `rewind`.
+// Chunks are kept for reuse across resets. Allocations larger than a quarter of a chunk get a
+// block of their own, returned to the system on reset. Not thread safe.
+class Arena {
+  static constexpr usize kDefaultChunkSize = 4096;
+
+  struct Chunk {
+    u8* ptr;
+    usize size;
+  };
+
+  struct Large {
+    void* ptr;
+    mem::Layout layout;
+  };
+
+  usize _chunk_size{kDefaultChunkSize};
+  List<Chunk> _chunks{};
+  List<Large> _large{};
+  usize _used{0};  // chunks in use, the last of them is being carved
+  u8* _pos{nullptr};
+  u8* _end{nullptr};
+
+ public:
+  Arena() noexcept;
+  ~Arena() noexcept;
+
+  Arena(Arena&& other) noexcept;
+  Arena& operator=(Arena&& other) noexcept;
+
+  static auto with_chunk_size(usize chunk_size) -> Arena;
+
+  struct Checkpoint {
+    usize used;
+    usize large;
+    u8* pos;
+  };
+
+ public:
+  auto allocate(mem::Layout layout) -> void*;
+  auto allocate_zeroed(mem::Layout layout) -> void*;
+  void deallocate(void* ptr, mem::Layout layout);
+  auto grow(void* ptr, mem::Layout layout, usize new_size) -> void*;
+  auto shrink(void* ptr, mem::Layout layout, usize new_size) -> void*;
+
+  // drops every allocation at once; nothing allocated from the arena may be used after
+  void reset();
+
+  // `rewind` drops every allocation made since `checkpoint`
+  auto checkpoint() const noexcept -> Checkpoint;
+  void rewind(const Checkpoint& mark);
+
+  auto allocated_bytes() const noexcept -> usize;
+
+ private:
+  auto alloc_large(mem::Layout layout) -> void*;
+  auto next_chunk(usize min_size) -> bool;
+};
+
+// A handle on an `Arena` with the interface of `alloc::Global`, so `List`, `Buffer`, `Queue`
+// and `HashMap` can allocate from it. The arena must outlive everything allocated through it.
+class ArenaRef {
+  Arena* _arena{nullptr};
+
+ public:
+  ArenaRef() noexcept = default;
+  ArenaRef(Arena& arena) noexcept : _arena{&arena} {}
+
+ public:
+  auto allocate(mem::Layout layout) -> void* {
+    return _arena->allocate(layout);
+  }
+
+  auto allocate_zeroed(mem::Layout layout) -> void* {
+    return _arena->allocate_zeroed(layout);
+  }
+
+  void deallocate(void* ptr, mem::Layout layout) {
+    _arena->deallocate(ptr, layout);
+  }
+
+  auto grow(void* ptr, mem::Layout layout, usize new_size) -> void* {
+    return _arena->grow(ptr, layout, new_size);
+  }
+
+  auto shrink(void* ptr, mem::Layout layout, usize new_size) -> void* {
+    return _arena->shrink(ptr, layout, new_size);
+  }
+};
+
+// Rewinds an arena to where it stood when the scope was opened. Everything allocated in the
+// scope must be gone by then.
+class [[nodiscard]] ArenaScope {
+  Arena& _arena;
+  Arena::Checkpoint _mark;
+
+ public:
+  explicit ArenaScope(Arena& arena) noexcept : _arena{arena}, _mark{arena.checkpoint()} {}
+
+  ~ArenaScope() noexcept {
+    _arena.rewind(_mark);
+  }
+
+  ArenaScope(const ArenaScope&) = delete;
+  ArenaScope& operator=(const ArenaScope&) = delete;
+};
+
+}  // namespace sfc::alloc
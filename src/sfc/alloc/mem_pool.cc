@@ -6,27 +6,141 @@ namespace sfc::mem_pool {
 
 static constexpr auto kDefaultAlign = alignof(double);
 
-class Bucket {
-  struct Node {
-    void* ptr;
-    usize seq;
-  };
+// Size classes: multiples of 16 up to 128, then four steps per power of two, up to 1 GiB.
+// Each request is rounded up to its class, so the space lost is at most a quarter of the
+// request. Larger requests bypass the pool.
+namespace size_class {
+
+static constexpr usize kQuantum = 16;
+static constexpr usize kSmallMax = 128;
+static constexpr usize kSmallClasses = kSmallMax / kQuantum;
+static constexpr usize kStepsLog2 = 2;
+static constexpr usize kMaxLog2 = 30;
+static constexpr usize kCount = kSmallClasses + (kMaxLog2 - 7) * (1U << kStepsLog2);
+static constexpr usize kNone = kCount;
+
+// sizes up to `kLookupMax` index a table by their count of quanta
+static constexpr usize kLookupMax = 4096;
+
+constexpr auto size_of(usize cls) noexcept -> usize {
+  if (cls < kSmallClasses) {
+    return (cls + 1) * kQuantum;
+  }
+  const auto grp = (cls - kSmallClasses) >> kStepsLog2;
+  const auto step = (cls - kSmallClasses) & ((1U << kStepsLog2) - 1);
+  const auto base = kSmallMax << grp;
+  return base + (step + 1) * (base >> kStepsLog2);
+}
+
+constexpr auto compute(usize size) noexcept -> usize {
+  if (size <= kSmallMax) {
+    return size == 0 ? 0 : (size - 1) / kQuantum;
+  }
+  if (size > (usize{1} << kMaxLog2)) {
+    return kNone;
+  }
+  const auto log2 = usize(63 - __builtin_clzll(size - 1));
+  const auto step = ((size - 1) - (usize{1} << log2)) >> (log2 - kStepsLog2);
+  return kSmallClasses + ((log2 - 7) << kStepsLog2) + step;
+}
+
+struct Lookup {
+  u8 cls[kLookupMax / kQuantum + 1];
+};
+
+static constexpr auto kLookup = [] {
+  auto res = Lookup{};
+  for (auto i = 0UL; i <= kLookupMax / kQuantum; ++i) {
+    res.cls[i] = u8(size_class::compute(i * kQuantum));
+  }
+  return res;
+}();
+
+// the class of `size`, or `kNone` if it is too large to pool
+inline auto of(usize size) noexcept -> usize {
+  if (size <= kLookupMax) {
+    return kLookup.cls[(size + kQuantum - 1) / kQuantum];
+  }
+  return size_class::compute(size);
+}
+
+static_assert(size_class::size_of(kCount - 1) == usize{1} << kMaxLog2);
+static_assert(size_class::compute(usize{1} << kMaxLog2) == kCount - 1);
+
+}  // namespace size_class
+
+// Classes up to `kMaxCarved` are carved out of chunks of 64 KiB to 2 MiB, at least 16 blocks
+// each after the chunk header; larger blocks come from the allocator one by one.
+static constexpr usize kMinChunk = usize{64} << 10;
+static constexpr usize kMaxChunk = usize{2} << 20;
+
+// The header at the start of a chunk, or of a free block too large to carve. A chunk is aligned
+// to its size, so a block finds its chunk by masking its address.
+struct Chunk {
+  Chunk* prev;  // in its bucket
+  Chunk* next;
+  Chunk* idle_prev;  // in the pool's idle list
+  Chunk* idle_next;
+  void* free;    // released blocks, linked through their first word
+  usize carved;  // offset of the first block never handed out
+  usize used;    // blocks handed out
+  usize cls;
+  u64 epoch;  // when it last went idle
+};
+
+static constexpr usize kChunkHeader = num::align_up(sizeof(Chunk), size_class::kQuantum);
+static constexpr usize kMaxCarved = (kMaxChunk - kChunkHeader) / 16;
 
+template <Chunk* Chunk::*kPrev, Chunk* Chunk::*kNext>
+struct Links {
+  static void push_back(ChunkList& list, Chunk* chunk) {
+    chunk->*kPrev = list.tail;
+    chunk->*kNext = nullptr;
+    (list.tail ? list.tail->*kNext : list.head) = chunk;
+    list.tail = chunk;
+  }
+
+  static void remove(ChunkList& list, Chunk* chunk) {
+    const auto prev = chunk->*kPrev;
+    const auto next = chunk->*kNext;
+    (prev ? prev->*kNext : list.head) = next;
+    (next ? next->*kPrev : list.tail) = prev;
+  }
+};
+
+using BucketLinks = Links<&Chunk::prev, &Chunk::next>;
+using IdleLinks = Links<&Chunk::idle_prev, &Chunk::idle_next>;
+
+class Bucket {
   usize _block_size;
-  List<Node> _free_list;
+  usize _chunk_size;  // 0 if the class is not carved
+  usize _cls;
+
+  // chunks in use with room left, and chunks no block lives in, oldest first; for classes too
+  // large to carve, `_empty` holds the free blocks themselves
+  ChunkList _avail{};
+  ChunkList _empty{};
 
  public:
-  explicit Bucket(usize block_size) noexcept : _block_size{block_size} {}
+  explicit Bucket(usize cls) noexcept
+      : _block_size{size_class::size_of(cls)}, _chunk_size{Bucket::chunk_size_for(_block_size)}, _cls{cls} {}
 
   ~Bucket() noexcept {}
 
   Bucket(Bucket&& other) noexcept
-      : _block_size{mem::take(other._block_size)}, _free_list{mem::move(other._free_list)} {}
+      : _block_size{mem::take(other._block_size)},
+        _chunk_size{mem::take(other._chunk_size)},
+        _cls{mem::take(other._cls)},
+        _avail{mem::take(other._avail)},
+        _empty{mem::take(other._empty)} {}
 
   Bucket& operator=(Bucket&& other) noexcept {
     if (this != &other) {
       _block_size = mem::take(other._block_size);
-      _free_list = mem::move(other._free_list);
+      _chunk_size = mem::take(other._chunk_size);
+      _cls = mem::take(other._cls);
+      _avail = mem::take(other._avail);
+      _empty = mem::take(other._empty);
     }
     return *this;
   }
@@ -36,148 +150,448 @@ class Bucket {
     return _block_size;
   }
 
-  auto fast_alloc() -> void* {
-    if (_free_list.is_empty()) {
-      return nullptr;
+  auto chunk_size() const -> usize {
+    return _chunk_size;
+  }
+
+  // what an idle unit of this class gives back to the allocator
+  auto unit_layout() const -> Layout {
+    if (_chunk_size != 0) {
+      return {_chunk_size, _chunk_size};
     }
-    const auto [ptr, _] = _free_list.pop().unwrap();
-    return ptr;
+    return {_block_size, kDefaultAlign};
   }
 
-  void fast_dealloc(void* ptr, usize seq) {
-    _free_list.push({ptr, seq});
+  auto fast_alloc(IdleList& idle) -> void* {
+    if (_chunk_size == 0) {
+      const auto block = _empty.tail;
+      if (block == nullptr) {
+        return nullptr;
+      }
+      this->unidle(idle, block);
+      return block;
+    }
+
+    // fill chunks already in use before touching an unused one, and then the most recent
+    auto chunk = _avail.head;
+    if (chunk == nullptr) {
+      chunk = _empty.tail;
+      if (chunk == nullptr) {
+        return nullptr;
+      }
+      this->unidle(idle, chunk);
+      BucketLinks::push_back(_avail, chunk);
+    }
+    const auto ptr = this->take(chunk);
+    if (!this->has_room(chunk)) {
+      BucketLinks::remove(_avail, chunk);
+    }
+    return ptr;
   }
 
-  auto age(usize seq) const noexcept -> f64 {
-    if (_free_list.is_empty()) {
-      return 0;
+  void fast_dealloc(IdleList& idle, void* ptr) {
+    if (_chunk_size == 0) {
+      const auto block = ptr::cast<Chunk>(ptr);
+      block->cls = _cls;
+      this->make_idle(idle, block);
+      return;
     }
 
-    const auto seq0 = _free_list[0].seq;
-    if (seq < seq0) {
+    const auto chunk = reinterpret_cast<Chunk*>(reinterpret_cast<usize>(ptr) & ~(_chunk_size - 1));
+    const auto was_full = !this->has_room(chunk);
+    *ptr::cast<void*>(ptr) = chunk->free;
+    chunk->free = ptr;
+    chunk->used -= 1;
+
+    if (chunk->used == 0) {
+      if (!was_full) {
+        BucketLinks::remove(_avail, chunk);
+      }
+      this->make_idle(idle, chunk);
+    } else if (was_full) {
+      BucketLinks::push_back(_avail, chunk);
+    }
+  }
+
+  // takes a fresh chunk of `chunk_size()` bytes, and hands out its first block
+  auto carve(void* mem) -> void* {
+    const auto chunk = ptr::cast<Chunk>(mem);
+    *chunk = Chunk{nullptr, nullptr, nullptr, nullptr, nullptr, kChunkHeader, 0, _cls, 0};
+    const auto ptr = this->take(chunk);
+    BucketLinks::push_back(_avail, chunk);
+    return ptr;
+  }
+
+  // unlinks an idle unit of this class, to reuse or release it
+  void unidle(IdleList& idle, Chunk* chunk) {
+    BucketLinks::remove(_empty, chunk);
+    IdleLinks::remove(idle.list, chunk);
+    idle.bytes -= this->unit_layout().size;
+  }
+
+ private:
+  static auto chunk_size_for(usize block_size) -> usize {
+    if (block_size > kMaxCarved) {
       return 0;
     }
+    return cmp::min(cmp::max(num::next_power_of_two(block_size * 16 + kChunkHeader), kMinChunk), kMaxChunk);
+  }
 
-    const auto age = f64(seq - seq0) * f64(_block_size >> 20U);
-    return age;
+  void make_idle(IdleList& idle, Chunk* chunk) {
+    chunk->epoch = idle.epoch;
+    BucketLinks::push_back(_empty, chunk);
+    IdleLinks::push_back(idle.list, chunk);
+    idle.bytes += this->unit_layout().size;
   }
 
-  struct Block {
-    void* ptr;
-    usize size;
+  auto has_room(const Chunk* chunk) const -> bool {
+    return chunk->free != nullptr || chunk->carved + _block_size <= _chunk_size;
+  }
+
+  auto take(Chunk* chunk) -> void* {
+    chunk->used += 1;
+    if (const auto ptr = chunk->free) {
+      chunk->free = *ptr::cast<void*>(ptr);
+      return ptr;
+    }
+    const auto ptr = ptr::cast<u8>(chunk) + chunk->carved;
+    chunk->carved += _block_size;
+    return ptr;
+  }
+};
+
+// set once the thread's cache is gone, so frees from later thread-exit destructors bypass it
+static thread_local constinit auto tls_cache_exited = false;
+
+// The blocks one thread keeps for itself, a magazine per pool and size. `alloc` and `dealloc`
+// touch only the magazine; the pool's lock is taken once per batch of `kBatch` blocks, when a
+// magazine runs dry or fills up.
+class ThreadCache {
+  static constexpr usize kBatch = 16;
+  static constexpr usize kMaxBlocks = 2 * kBatch;
+
+ public:
+  // classes up to 32 KiB; a magazine of larger blocks would pin too much memory to a thread
+  static constexpr usize kClasses = size_class::compute(usize{32} << 10) + 1;
+
+ private:
+  struct Magazines {
+    Pool* pool;
+    List<void*> blocks[kClasses];
   };
 
-  auto pop_first() -> Block {
-    if (_free_list.is_empty()) {
-      return {nullptr, 0};
+  List<Magazines> _pools{};
+  usize _last{0};
+
+ public:
+  ThreadCache() noexcept = default;
+
+  ~ThreadCache() noexcept {
+    this->flush(nullptr);
+    tls_cache_exited = true;
+  }
+
+  ThreadCache(const ThreadCache&) = delete;
+  ThreadCache& operator=(const ThreadCache&) = delete;
+
+  static auto local() -> ThreadCache*;
+
+ public:
+  auto alloc(Pool& pool, usize cls) -> void* {
+    auto& mag = this->magazines(pool).blocks[cls];
+    if (mag.is_empty()) {
+      pool.fast_alloc_batch(cls, mag, kBatch);
+    }
+    if (auto ptr = mag.pop()) {
+      return *ptr;
+    }
+    return nullptr;
+  }
+
+  void dealloc(Pool& pool, void* ptr, usize cls) {
+    auto& mag = this->magazines(pool).blocks[cls];
+    mag.push(ptr);
+    if (mag.len() >= kMaxBlocks) {
+      pool.fast_dealloc_batch(cls, mag, kBatch);
+    }
+  }
+
+  // returns the magazines of `pool`, or of every pool if null
+  void flush(const Pool* pool) {
+    for (auto idx = _pools.len(); idx != 0; --idx) {
+      auto& mags = _pools[idx - 1];
+      if (pool != nullptr && mags.pool != pool) {
+        continue;
+      }
+      for (auto cls = 0UL; cls < kClasses; ++cls) {
+        if (!mags.blocks[cls].is_empty()) {
+          mags.pool->fast_dealloc_batch(cls, mags.blocks[cls], mags.blocks[cls].len());
+        }
+      }
+      (void)_pools.remove(idx - 1);
+    }
+    _last = 0;
+  }
+
+ private:
+  auto magazines(Pool& pool) -> Magazines& {
+    // a thread mostly uses one pool, so the last hit is checked first
+    if (_last < _pools.len() && _pools[_last].pool == &pool) {
+      return _pools[_last];
+    }
+    for (auto idx = 0UL; idx < _pools.len(); ++idx) {
+      if (_pools[idx].pool == &pool) {
+        _last = idx;
+        return _pools[idx];
+      }
     }
-    const auto [ptr, _] = _free_list.remove(0);
-    return {ptr, _block_size};
+    _last = _pools.len();
+    return _pools.push(Magazines{&pool, {}});
   }
 };
 
-Pool::Pool(usize cap) noexcept : _cap{cap}, _buckets{} {}
+static thread_local auto tls_cache = ThreadCache{};
+
+auto ThreadCache::local() -> ThreadCache* {
+  if (tls_cache_exited) {
+    return nullptr;
+  }
+  return &tls_cache;
+}
+
+Pool::Pool(usize cap) noexcept : _cap{cap}, _buckets{List<Bucket>::with_capacity(size_class::kCount)} {
+  for (auto cls = 0UL; cls < size_class::kCount; ++cls) {
+    _buckets.push(Bucket{cls});
+  }
+}
 
-Pool::~Pool() noexcept {}
+Pool::~Pool() noexcept {
+  this->stop_trimmer();
+  if (_thread_cache) {
+    this->flush_thread_cache();
+  }
+}
+
+void Pool::set_thread_cache(bool enable) {
+  if (!enable) {
+    this->flush_thread_cache();
+  }
+  _thread_cache = enable;
+}
+
+void Pool::flush_thread_cache() {
+  if (auto cache = ThreadCache::local()) {
+    cache->flush(this);
+  }
+}
 
 auto Pool::total_bytes() const noexcept -> usize {
+  auto lock = _mutex.lock();
   return _total_bytes;
 }
 
 auto Pool::free_bytes() const noexcept -> usize {
+  auto lock = _mutex.lock();
   return _free_bytes;
 }
 
-auto Pool::bucket(usize size) -> Bucket& {
-  auto opt = _buckets.iter_mut().find([&](auto& b) { return b.block_size() == size; });
-  if (opt.is_some()) {
-    return *opt;
-  }
+auto Pool::idle_bytes() const noexcept -> usize {
+  auto lock = _mutex.lock();
+  return _idle.bytes;
+}
 
-  auto& bkt = _buckets.push(Bucket{size});
-  return bkt;
+auto Pool::bucket(usize cls) -> Bucket& {
+  return _buckets[cls];
 }
 
-auto Pool::find_oldest_bucket() -> Bucket& {
-  Bucket* bkt = &_buckets[0];
+auto Pool::fast_alloc(usize cls) -> void* {
+  auto lock = _mutex.lock();
+  auto& bkt = bucket(cls);
 
-  auto max_age = 0.0;
-  for (auto& b : _buckets) {
-    const auto a = b.age(_seq);
-    if (a > max_age) {
-      max_age = a;
-      bkt = &b;
-    }
+  auto ptr = bkt.fast_alloc(_idle);
+  if (ptr != nullptr) {
+    _free_bytes -= bkt.block_size();
   }
-
-  return *bkt;
+  return ptr;
 }
 
-auto Pool::fast_alloc(usize size) -> void* {
+void Pool::fast_dealloc(void* ptr, usize cls) {
   auto lock = _mutex.lock();
-  auto& bkt = bucket(size);
+  auto& bkt = bucket(cls);
+  bkt.fast_dealloc(_idle, ptr);
+  _free_bytes += bkt.block_size();
+  this->check_cap();
+}
 
-  auto ptr = bkt.fast_alloc();
-  if (ptr != nullptr) {
-    _free_bytes -= size;
+void Pool::fast_alloc_batch(usize cls, List<void*>& out, usize cnt) {
+  auto lock = _mutex.lock();
+  auto& bkt = bucket(cls);
+  for (; cnt != 0; --cnt) {
+    const auto ptr = bkt.fast_alloc(_idle);
+    if (ptr == nullptr) {
+      break;
+    }
+    out.push(ptr);
+    _free_bytes -= bkt.block_size();
   }
-  return ptr;
 }
 
-void Pool::fast_dealloc(void* ptr, usize size) {
+void Pool::fast_dealloc_batch(usize cls, List<void*>& blocks, usize cnt) {
   auto lock = _mutex.lock();
-  auto& bkt = bucket(size);
-  bkt.fast_dealloc(ptr, _seq++);
-  _free_bytes += size;
+  auto& bkt = bucket(cls);
+  for (; cnt != 0; --cnt) {
+    bkt.fast_dealloc(_idle, blocks.pop().unwrap());
+    _free_bytes += bkt.block_size();
+  }
+  this->check_cap();
+}
+
+// called with the lock held: the release itself is left to the trimmer
+void Pool::check_cap() {
+  if (_idle.bytes > _cap) {
+    _trimmer_cv.notify_one();
+  }
 }
 
 auto Pool::alloc(usize size) -> void* {
-  if (auto ptr = this->fast_alloc(size)) {
-    return ptr;
+  const auto cls = size_class::of(size);
+  if (cls == size_class::kNone) {
+    return this->slow_alloc({size, kDefaultAlign});
   }
 
-  this->recycling(false, size);
-  auto ptr = this->slow_alloc({size, kDefaultAlign});
+  if (const auto cache = _thread_cache && cls < ThreadCache::kClasses ? ThreadCache::local() : nullptr) {
+    if (auto ptr = cache->alloc(*this, cls)) {
+      return ptr;
+    }
+  } else if (auto ptr = this->fast_alloc(cls)) {
+    return ptr;
+  }
 
-  // register
-  if (ptr) {
-    _total_bytes += size;
+  // the allocator is called without the lock held
+  auto& bkt = bucket(cls);
+  const auto layout = bkt.unit_layout();
+  const auto mem = this->slow_alloc(layout);
+  if (mem == nullptr) {
+    return nullptr;
   }
 
-  return ptr;
+  auto lock = _mutex.lock();
+  _total_bytes += layout.size;
+  if (bkt.chunk_size() == 0) {
+    return mem;
+  }
+  _free_bytes += layout.size - bkt.block_size();
+  return bkt.carve(mem);
 }
 
 void Pool::dealloc(void* ptr, usize size) {
-  this->fast_dealloc(ptr, size);
-}
+  const auto cls = size_class::of(size);
+  if (cls == size_class::kNone) {
+    this->slow_dealloc(ptr, {size, kDefaultAlign});
+    return;
+  }
 
-auto Pool::recycling(bool force, usize cap) -> usize {
-  if (_buckets.is_empty()) {
-    return 0U;
+  if (const auto cache = _thread_cache && cls < ThreadCache::kClasses ? ThreadCache::local() : nullptr) {
+    cache->dealloc(*this, ptr, cls);
+    return;
   }
+  this->fast_dealloc(ptr, cls);
+}
 
+// Unlinks idle units, oldest first: at least `budget` bytes if there are, and every unit that
+// went idle before `before_epoch`. The caller releases them once the lock is dropped.
+auto Pool::take_idle(usize budget, u64 before_epoch) -> ChunkList {
+  auto res = ChunkList{};
   auto amt = usize{0};
-  while (force || amt < cap) {
-    if (!force && _free_bytes < _cap) {
+  while (const auto unit = _idle.list.head) {
+    if (amt >= budget && unit->epoch >= before_epoch) {
       break;
     }
 
-    auto& bucket = this->find_oldest_bucket();
-    const auto block = bucket.pop_first();
-    if (block.ptr == nullptr) {
-      break;
-    }
+    auto& bkt = bucket(unit->cls);
+    const auto size = bkt.unit_layout().size;
+    bkt.unidle(_idle, unit);
+    IdleLinks::push_back(res, unit);
+    _free_bytes -= size;
+    _total_bytes -= size;
+    amt += size;
+  }
+  return res;
+}
 
-    this->slow_dealloc(block.ptr, {block.size, kDefaultAlign});
-    _free_bytes -= block.size;
-    _total_bytes -= block.size;
-    amt += block.size;
+auto Pool::release(ChunkList units) -> usize {
+  auto amt = usize{0};
+  for (auto unit = units.head; unit != nullptr;) {
+    const auto next = unit->idle_next;
+    const auto layout = bucket(unit->cls).unit_layout();
+    this->slow_dealloc(unit, layout);
+    amt += layout.size;
+    unit = next;
   }
   return amt;
 }
 
+auto Pool::trim(usize budget) -> usize {
+  auto units = ChunkList{};
+  {
+    auto lock = _mutex.lock();
+    units = this->take_idle(budget, 0);
+  }
+  return this->release(units);
+}
+
+void Pool::start_trimmer(time::Duration period) {
+  this->stop_trimmer();
+  _trimmer_stop = false;
+  _trimmer = thread::spawn([this, period]() { this->trimmer_loop(period); });
+}
+
+void Pool::stop_trimmer() {
+  {
+    auto lock = _mutex.lock();
+    _trimmer_stop = true;
+    _trimmer_cv.notify_all();
+  }
+  if (auto handle = mem::take(_trimmer)) {
+    handle->join();
+  }
+}
+
+void Pool::trimmer_loop(time::Duration period) {
+  while (true) {
+    auto units = ChunkList{};
+    {
+      auto lock = _mutex.lock();
+      if (_trimmer_stop) {
+        return;
+      }
+      // no wait while over the cap: `dealloc` may have crossed it before the trimmer was waiting
+      const auto woken = _idle.bytes > _cap || _trimmer_cv.wait_timeout(lock, period);
+      if (_trimmer_stop) {
+        return;
+      }
+
+      // on a tick, units idle since before the last tick have been idle for a whole period;
+      // woken by `dealloc`, only the excess over the cap goes
+      const auto over = _idle.bytes > _cap ? _idle.bytes - _cap : 0;
+      if (woken) {
+        units = this->take_idle(over, 0);
+      } else {
+        _idle.epoch += 1;
+        units = this->take_idle(over, _idle.epoch - 1);
+      }
+    }
+    this->release(units);
+  }
+}
+
 auto Pool::global() -> Pool& {
-  static auto pool = XPool{alloc::Global{}};
+  // shared by every thread, so each keeps a cache in front of it; no trimmer unless asked for
+  static auto& pool = []() -> Pool& {
+    static auto res = XPool{alloc::Global{}};
+    res.set_thread_cache(true);
+    return res;
+  }();
   return pool;
 }
 
@@ -1,9 +1,15 @@
 #include "sfc/alloc/alloc.h"
 #include "sfc/alloc/mem_pool.h"
 #include "sfc/test/test.h"
+#include "sfc/thread.h"
 
 namespace sfc::mem_pool::test {
 
+// bytes handed out and not yet returned
+static auto in_use(const Pool& pool) -> usize {
+  return pool.total_bytes() - pool.free_bytes();
+}
+
 // A fresh pool reports zero usage; allocate/dealloc round-trip is non-null.
 SFC_TEST(mpool_alloc_basic) {
   auto pool = XPool{alloc::Global{}};
@@ -14,14 +20,15 @@ SFC_TEST(mpool_alloc_basic) {
   auto* ptr = pool.alloc(64);
   sfc::assert_ne(ptr, nullptr);
 
-  // Issuing a block increases outstanding bytes, nothing free yet.
+  // Issuing a block takes a whole chunk; only the block is outstanding.
   sfc::assert_ge(pool.total_bytes(), 64U);
-  sfc::assert_eq(pool.free_bytes(), 0U);
+  sfc::assert_eq(in_use(pool), 64U);
   pool.dealloc(ptr, 64);
+  sfc::assert_eq(in_use(pool), 0U);
 }
 
 // After dealloc, the block lands in the free list: a subsequent allocate of
-// the same size is served from the cache (free_bytes drops back to 0).
+// the same size is served from the cache, without growing the pool.
 SFC_TEST(mpool_cache_reuse) {
   auto pool = XPool{alloc::Global{}};
 
@@ -30,17 +37,18 @@ SFC_TEST(mpool_cache_reuse) {
   pool.dealloc(p1, 128);
 
   // The just-released block is now cached.
-  sfc::assert_eq(pool.free_bytes(), 128U);
+  const auto total = pool.total_bytes();
+  sfc::assert_eq(pool.free_bytes(), total);
 
   auto* p2 = pool.alloc(128);
-  sfc::assert_ne(p2, nullptr);
-  sfc::assert_eq(pool.free_bytes(), 0U);
+  sfc::assert_eq(p2, p1);
+  sfc::assert_eq(pool.total_bytes(), total);
+  sfc::assert_eq(in_use(pool), 128U);
 
   pool.dealloc(p2, 128);
 }
 
-// Distinct sizes are tracked in separate buckets; freeing two different sizes
-// yields the sum of both in free_bytes.
+// Distinct sizes are tracked in separate buckets, each with its own chunk.
 SFC_TEST(mpool_distinct_sizes) {
   auto pool = XPool{alloc::Global{}};
 
@@ -49,19 +57,45 @@ SFC_TEST(mpool_distinct_sizes) {
   sfc::assert_ne(a, nullptr);
   sfc::assert_ne(b, nullptr);
 
+  sfc::assert_eq(in_use(pool), 64U + 256U);
   pool.dealloc(a, 64);
   pool.dealloc(b, 256);
-
-  sfc::assert_eq(pool.free_bytes(), 64U + 256U);
+  sfc::assert_eq(in_use(pool), 0U);
 
   // Re-allocating either size is served from cache.
+  const auto total = pool.total_bytes();
   auto* a2 = pool.alloc(64);
-  sfc::assert_ne(a2, nullptr);
-  sfc::assert_eq(pool.free_bytes(), 256U);
+  sfc::assert_eq(a2, a);
+  sfc::assert_eq(pool.total_bytes(), total);
+  sfc::assert_eq(in_use(pool), 64U);
 
   pool.dealloc(a2, 64);
 }
 
+// Sizes are rounded up to their size class, so nearby sizes share blocks.
+SFC_TEST(mpool_size_class) {
+  auto pool = XPool{alloc::Global{}};
+
+  auto* a = pool.alloc(100);
+  sfc::assert_eq(in_use(pool), 112U);
+  pool.dealloc(a, 100);
+
+  // 97..112 is one class: the freed block is reused
+  auto* b = pool.alloc(112);
+  sfc::assert_eq(b, a);
+  sfc::assert_eq(in_use(pool), 112U);
+  pool.dealloc(b, 112);
+
+  // above 128 bytes, four classes per power of two
+  auto* c = pool.alloc(1000);
+  sfc::assert_eq(in_use(pool), 1024U);
+  auto* d = pool.alloc(5000);
+  sfc::assert_eq(in_use(pool), 1024U + 5120U);
+  pool.dealloc(c, 1000);
+  pool.dealloc(d, 5000);
+  sfc::assert_eq(in_use(pool), 0U);
+}
+
 // Repeated allocate/dealloc churn keeps the pool stable and non-null.
 SFC_TEST(mpool_churn) {
   auto pool = XPool{alloc::Global{}};
@@ -72,8 +106,139 @@ SFC_TEST(mpool_churn) {
     pool.dealloc(p, 64);
   }
 
-  // After churn everything returned is cached at size 64.
-  sfc::assert_eq(pool.free_bytes(), 64U);
+  // After churn everything returned is cached, in a single chunk.
+  sfc::assert_eq(in_use(pool), 0U);
+  sfc::assert_eq(pool.total_bytes(), 64U << 10);
+}
+
+// With thread caches, released blocks stay with the thread until flushed.
+SFC_TEST(mpool_thread_cache) {
+  auto pool = XPool{alloc::Global{}};
+  pool.set_thread_cache(true);
+
+  auto* p = pool.alloc(64);
+  pool.dealloc(p, 64);
+  sfc::assert_eq(in_use(pool), 64U);
+  sfc::assert_eq(pool.alloc(64), p);
+  pool.dealloc(p, 64);
+
+  pool.flush_thread_cache();
+  sfc::assert_eq(in_use(pool), 0U);
+
+  // a refill takes a batch of blocks at once
+  p = pool.alloc(64);
+  sfc::assert_gt(in_use(pool), 64U);
+  pool.dealloc(p, 64);
+  pool.flush_thread_cache();
+  sfc::assert_eq(in_use(pool), 0U);
+}
+
+// Threads churn through one pool; each cache is returned when its thread exits.
+SFC_TEST(mpool_thread_exit) {
+  static constexpr auto kBlocks = 100U;
+  auto pool = XPool{alloc::Global{}};
+  pool.set_thread_cache(true);
+
+  auto worker = [&]() {
+    void* ptrs[kBlocks];
+    for (auto n = 0U; n < 10U; ++n) {
+      for (auto i = 0U; i < kBlocks; ++i) {
+        ptrs[i] = pool.alloc(32 + (i % 2) * 32);
+      }
+      for (auto i = 0U; i < kBlocks; ++i) {
+        pool.dealloc(ptrs[i], 32 + (i % 2) * 32);
+      }
+    }
+  };
+  {
+    auto t0 = thread::spawn_joined(worker);
+    auto t1 = thread::spawn_joined(worker);
+    auto t2 = thread::spawn_joined(worker);
+  }
+  sfc::assert_ne(pool.free_bytes(), 0U);
+  sfc::assert_eq(pool.free_bytes(), pool.total_bytes());
+}
+
+// Small blocks are carved from one chunk; a chunk goes back only once all its blocks are free.
+SFC_TEST(mpool_chunks) {
+  static constexpr auto kChunk = usize{64} << 10;
+  auto pool = XPool{alloc::Global{}};
+
+  void* ptrs[500];
+  for (auto& p : ptrs) {
+    p = pool.alloc(64);
+  }
+  sfc::assert_eq(pool.total_bytes(), kChunk);
+  const auto base = reinterpret_cast<usize>(ptrs[0]) & ~(kChunk - 1);
+  for (auto p : ptrs) {
+    sfc::assert_eq(reinterpret_cast<usize>(p) & ~(kChunk - 1), base);
+  }
+
+  // with one block still out, the chunk is not idle
+  for (auto i = 1U; i < 500U; ++i) {
+    pool.dealloc(ptrs[i], 64);
+  }
+  auto* a = pool.alloc(256);
+  pool.dealloc(a, 256);
+  sfc::assert_eq(pool.idle_bytes(), kChunk);
+  sfc::assert_eq(pool.trim(kChunk), kChunk);
+  sfc::assert_eq(pool.total_bytes(), kChunk);
+
+  pool.dealloc(ptrs[0], 64);
+  sfc::assert_eq(pool.idle_bytes(), kChunk);
+}
+
+// Large blocks are pooled one by one, and trimmed oldest first.
+SFC_TEST(mpool_trim) {
+  static constexpr auto kSize = usize{256} << 10;
+  auto pool = XPool{alloc::Global{}};
+
+  auto* a = pool.alloc(kSize);
+  auto* b = pool.alloc(kSize);
+  pool.dealloc(a, kSize);
+  pool.dealloc(b, kSize);
+  sfc::assert_eq(pool.idle_bytes(), 2 * kSize);
+
+  sfc::assert_eq(pool.trim(1), kSize);
+  sfc::assert_eq(pool.alloc(kSize), b);
+  sfc::assert_eq(pool.idle_bytes(), 0U);
+  pool.dealloc(b, kSize);
+
+  sfc::assert_eq(pool.trim(num::Int<usize>::MAX), kSize);
+  sfc::assert_eq(pool.total_bytes(), 0U);
+}
+
+// The trimmer releases memory that stays idle for a whole period.
+SFC_TEST(mpool_trimmer) {
+  auto pool = XPool{alloc::Global{}};
+  pool.start_trimmer(time::Duration::from_millis(5));
+
+  auto* p = pool.alloc(1000);
+  pool.dealloc(p, 1000);
+  for (auto i = 0U; i < 200U && pool.total_bytes() != 0; ++i) {
+    thread::sleep_ms(5);
+  }
+  sfc::assert_eq(pool.total_bytes(), 0U);
+  pool.stop_trimmer();
+}
+
+// Idle memory above the cap wakes the trimmer at once, not on its next tick.
+SFC_TEST(mpool_trimmer_cap) {
+  static constexpr auto kSize = usize{256} << 10;
+  auto pool = XPool{alloc::Global{}, kSize};
+  pool.start_trimmer(time::Duration::from_secs(3600));
+
+  auto* a = pool.alloc(kSize);
+  auto* b = pool.alloc(kSize);
+  pool.dealloc(a, kSize);
+  sfc::assert_eq(pool.idle_bytes(), kSize);
+  pool.dealloc(b, kSize);
+  for (auto i = 0U; i < 200U && pool.idle_bytes() > kSize; ++i) {
+    thread::sleep_ms(5);
+  }
+  sfc::assert_eq(pool.idle_bytes(), kSize);
+  sfc::assert_eq(pool.total_bytes(), kSize);
+  pool.stop_trimmer();
 }
 
 SFC_TEST(allocator) {
@@ -1,15 +1,34 @@
 #pragma once
 
 #include "sfc/alloc/list.h"
-#include "sfc/sync/mutex.h"
+#include "sfc/sync/condvar.h"
+#include "sfc/thread/join_handle.h"
 
 namespace sfc::mem_pool {
 
 using mem::Layout;
 
 class Bucket;
+class ThreadCache;
+struct Chunk;
+
+// the ends of an intrusive list of chunks
+struct ChunkList {
+  Chunk* head = nullptr;
+  Chunk* tail = nullptr;
+};
+
+// Memory no block lives in, for every class and oldest first: unused chunks, and free blocks of
+// the classes too large to carve. Each unit is stamped with the trimmer's epoch when it goes idle.
+struct IdleList {
+  ChunkList list{};
+  usize bytes{0};
+  u64 epoch{0};
+};
 
 class [[nodiscard]] Pool {
+  friend class ThreadCache;
+
  public:
   explicit Pool(usize cap) noexcept;
   virtual ~Pool() noexcept;
@@ -22,28 +41,60 @@ class [[nodiscard]] Pool {
  public:
   auto total_bytes() const noexcept -> usize;
   auto free_bytes() const noexcept -> usize;
+  auto idle_bytes() const noexcept -> usize;
 
+  // `size` is rounded up to its size class; sizes above 1 GiB go straight to the allocator
   auto alloc(usize size) -> void*;
   void dealloc(void* ptr, usize size);
 
+  // Opt-in: each thread keeps a small cache of blocks per size, served without the lock and
+  // exchanged with the pool in batches. A thread's cache goes back to the pool when the thread
+  // exits, so the pool must outlive every thread using it, or each must `flush_thread_cache`.
+  void set_thread_cache(bool enable);
+
+  // returns the calling thread's cached blocks to the pool
+  void flush_thread_cache();
+
+  // Gives idle memory back to the allocator, oldest first, until at least `budget` bytes are
+  // gone or nothing is idle; returns the bytes released. `alloc` and `dealloc` never release
+  // memory themselves: that is left to `trim` and the trimmer.
+  auto trim(usize budget) -> usize;
+
+  // Starts a thread that wakes every `period` and releases what has been idle for a whole
+  // period. `dealloc` also wakes it as soon as idle memory is above the pool's cap, to release
+  // the excess: without a trimmer the cap is not enforced. `global` starts none; a program
+  // bounds it with `Pool::global().start_trimmer(period)`, or calls `Pool::global().trim`.
+  void start_trimmer(time::Duration period);
+  void stop_trimmer();
+
  protected:
-  auto bucket(usize size) -> Bucket&;
-  auto find_oldest_bucket() -> Bucket&;
+  auto bucket(usize cls) -> Bucket&;
+
+  auto fast_alloc(usize cls) -> void*;
+  void fast_dealloc(void* ptr, usize cls);
+  void fast_alloc_batch(usize cls, List<void*>& out, usize cnt);
+  void fast_dealloc_batch(usize cls, List<void*>& blocks, usize cnt);
 
-  auto fast_alloc(usize size) -> void*;
-  void fast_dealloc(void* ptr, usize size);
-  auto recycling(bool force, usize cap = 0) -> usize;
+  auto take_idle(usize budget, u64 before_epoch) -> ChunkList;
+  auto release(ChunkList units) -> usize;
+  void check_cap();
+  void trimmer_loop(time::Duration period);
 
   virtual auto slow_alloc(Layout layout) -> void* = 0;
   virtual void slow_dealloc(void* ptr, Layout layout) = 0;
 
  private:
   const usize _cap;
+  bool _thread_cache{false};
   mutable sync::Mutex _mutex{};
-  usize _seq{0};
   usize _total_bytes{0};
   usize _free_bytes{0};
-  List<Bucket> _buckets;
+  List<Bucket> _buckets;  // one per size class
+  IdleList _idle{};
+
+  sync::Condvar _trimmer_cv{};
+  bool _trimmer_stop{false};
+  Option<thread::JoinHandle> _trimmer{};
 };
 
 template <class A>
@@ -53,7 +104,13 @@ class [[nodiscard]] XPool : public Pool {
 
  public:
   explicit XPool(A a, usize cap = kMaxFreeSize) : Pool{cap}, _alloc{mem::move(a)} {}
-  ~XPool() noexcept {}
+
+  // returns every free block and unused chunk; chunks still in use are left to their owners
+  ~XPool() noexcept {
+    this->stop_trimmer();
+    this->flush_thread_cache();
+    this->trim(num::Int<usize>::MAX);
+  }
 
  private:
   void* slow_alloc(Layout layout) override {
@@ -79,6 +79,21 @@ class [[nodiscard]] String {
   // trait: ops::Eq
   auto operator==(Str other) const noexcept -> bool;
 
+  // trait: ops::Ord
+  auto operator<=>(Str other) const noexcept -> int {
+    return this->as_str().cmp(other);
+  }
+
+  // trait: hash::Hash
+  auto hash() const noexcept -> usize {
+    return this->as_str().hash();
+  }
+
+  // trait: hash::Hash
+  void hash(auto& hasher) const noexcept {
+    this->as_str().hash(hasher);
+  }
+
   // trait: Clone
   auto clone() const noexcept -> String;
 
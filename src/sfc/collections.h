@@ -2,3 +2,8 @@
 
 #include "sfc/collections/queue.h"
 #include "sfc/collections/hash.h"
+#include "sfc/collections/btree.h"
+#include "sfc/collections/filter.h"
+#include "sfc/collections/slot_map.h"
+#include "sfc/collections/binary_heap.h"
+#include "sfc/collections/radix_map.h"
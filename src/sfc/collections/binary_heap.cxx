@@ -0,0 +1,138 @@
+#include "sfc/collections/binary_heap.h"
+#include "sfc/alloc/string.h"
+#include "sfc/test/test.h"
+
+namespace sfc::collections::binary_heap::test {
+
+SFC_TEST(heap_push_pop) {
+  auto h = BinaryHeap<u32>{};
+  sfc::assert_eq(h.peek().is_none(), true);
+  sfc::assert_eq(h.pop(), None{});
+
+  const u32 vals[] = {5, 1, 8, 3, 9, 2, 8, 7};
+  for (auto v : vals) {
+    h.push(v);
+  }
+  sfc::assert_eq(h.len(), 8U);
+  sfc::assert_eq(h.peek(), Option{9U});
+
+  const u32 expect[] = {9, 8, 8, 7, 5, 3, 2, 1};
+  for (auto v : expect) {
+    sfc::assert_eq(h.pop(), Option{v});
+  }
+  sfc::assert_eq(h.is_empty(), true);
+}
+
+SFC_TEST(heap_arity) {
+  auto h2 = BinaryHeap<u32, 2>{};
+  auto h8 = BinaryHeap<u32, 8>{};
+  auto x = 12345U;
+  for (auto i = 0U; i < 1000U; ++i) {
+    x = x * 1103515245U + 12345U;
+    h2.push(x >> 16);
+    h8.push(x >> 16);
+  }
+  for (auto prev = *h2.peek(); auto v = h2.pop();) {
+    sfc::assert_eq(*v <= prev, true);
+    sfc::assert_eq(h8.pop(), v);
+    prev = *v;
+  }
+  sfc::assert_eq(h8.is_empty(), true);
+}
+
+SFC_TEST(heap_from_list) {
+  auto list = List<u32>{};
+  for (auto i = 0U; i < 100U; ++i) {
+    list.push((i * 37) % 100);
+  }
+  auto h = BinaryHeap<u32>::from(mem::move(list));
+  sfc::assert_eq(h.len(), 100U);
+  sfc::assert_eq(h.peek(), Option{99U});
+
+  h.push(200);
+  sfc::assert_eq(h.push_pop(300), 300U);
+  sfc::assert_eq(h.push_pop(0), 200U);
+
+  const auto sorted = mem::move(h).into_sorted();
+  sfc::assert_eq(sorted.len(), 101U);
+  sfc::assert_eq(sorted[0], 0U);
+  for (auto i = 1U; i < sorted.len(); ++i) {
+    sfc::assert_eq(sorted[i], i - 1);
+  }
+}
+
+SFC_TEST(heap_min_strings) {
+  auto h = BinaryHeap<cmp::Reverse<String>>{};
+  const Str words[] = {"pear", "apple", "fig", "banana"};
+  for (auto w : words) {
+    h.push({String::from(w)});
+  }
+
+  auto list = List<cmp::Reverse<String>>{};
+  list.push({String::from("cherry")});
+  h.append(list);
+  sfc::assert_eq(list.is_empty(), true);
+
+  const Str expect[] = {"apple", "banana", "cherry", "fig", "pear"};
+  for (auto w : expect) {
+    sfc::assert_eq(h.pop()->_0, w);
+  }
+}
+
+SFC_TEST(indexed_heap) {
+  auto h = IndexedHeap<u64>{};
+  h.push(3, 30);
+  h.push(1, 10);
+  h.push(7, 70);
+  h.push(5, 50);
+  sfc::assert_eq(h.len(), 4U);
+  sfc::assert_eq(h.contains(2), false);
+  sfc::assert_eq(h.priority(5), Option{50UL});
+
+  h.decrease_key(7, 5);
+  sfc::assert_eq((*h.peek())._0, 7U);
+
+  // push of an existing id changes its priority, up or down
+  h.push(1, 60);
+  sfc::assert_eq(h.priority(1), Option{60UL});
+  sfc::assert_eq(h.remove(3), Option{30UL});
+  sfc::assert_eq(h.remove(3), None{});
+
+  const usize order[] = {7, 5, 1};
+  for (auto id : order) {
+    const auto top = h.pop();
+    sfc::assert_eq((*top)._0, id);
+    sfc::assert_eq(h.contains(id), false);
+  }
+  sfc::assert_eq(h.pop().is_none(), true);
+}
+
+SFC_TEST(indexed_heap_churn) {
+  static constexpr auto kIds = 200U;
+  auto h = IndexedHeap<u32>::with_capacity(kIds);
+  u32 prio[kIds] = {};
+  auto x = 1U;
+  for (auto i = 0U; i < 5000U; ++i) {
+    x = x * 1103515245U + 12345U;
+    const auto id = (x >> 8) % kIds;
+    const auto p = (x >> 12) % 1000;
+    if (h.contains(id) && p % 4 == 0) {
+      sfc::assert_eq(h.remove(id), Option{prio[id]});
+    } else if (h.contains(id) && p < prio[id]) {
+      h.decrease_key(id, p);
+      prio[id] = p;
+    } else {
+      h.push(id, p);
+      prio[id] = p;
+    }
+  }
+
+  auto last = 0U;
+  while (auto top = h.pop()) {
+    sfc::assert_eq((*top)._1, prio[(*top)._0]);
+    sfc::assert_eq((*top)._1 >= last, true);
+    last = (*top)._1;
+  }
+}
+
+}  // namespace sfc::collections::binary_heap::test
@@ -0,0 +1,348 @@
+#pragma once
+
+#include "sfc/alloc/list.h"
+
+namespace sfc::collections::binary_heap {
+
+// A max-heap in a `List`, ordered by `operator<`; wrap values in `cmp::Reverse` for a min-heap.
+// Each node has `D` children: a wider node makes the tree shallower and keeps the children of
+// one node in the same cache line, at the cost of more comparisons per level on the way down.
+template <class T, usize D = 4, class A = alloc::Global>
+class BinaryHeap {
+  static_assert(D >= 2, "BinaryHeap: arity must be at least 2");
+
+  List<T, A> _buf{};
+
+ public:
+  BinaryHeap() noexcept = default;
+
+  static auto with_capacity(usize capacity, A alloc = {}) -> BinaryHeap {
+    auto res = BinaryHeap{};
+    res._buf = List<T, A>::with_capacity(capacity, alloc);
+    return res;
+  }
+
+  // heapifies `list` in place, in O(n)
+  static auto from(List<T, A> list) -> BinaryHeap {
+    auto res = BinaryHeap{};
+    res._buf = mem::move(list);
+    res.rebuild();
+    return res;
+  }
+
+  auto len() const noexcept -> usize {
+    return _buf.len();
+  }
+
+  auto is_empty() const noexcept -> bool {
+    return _buf.is_empty();
+  }
+
+  auto capacity() const noexcept -> usize {
+    return _buf.capacity();
+  }
+
+  void reserve(usize additional) {
+    _buf.reserve(additional);
+  }
+
+  // the values in heap order, which is no particular order
+  auto as_slice() const noexcept -> Slice<const T> {
+    return _buf.as_slice();
+  }
+
+  auto iter() const noexcept {
+    return _buf.iter();
+  }
+
+  // the greatest value
+  auto peek() const noexcept -> Option<const T&> {
+    return _buf.first();
+  }
+
+ public:
+  void push(T val) {
+    _buf.push(mem::move(val));
+    this->sift_up(_buf.len() - 1);
+  }
+
+  // removes the greatest value
+  auto pop() -> Option<T> {
+    auto res = _buf.pop();
+    if (res && !_buf.is_empty()) {
+      mem::swap(*res, _buf[0]);
+      this->sift_down(0, _buf.len());
+    }
+    return res;
+  }
+
+  // pushes `val` and pops the greatest value in one sift
+  auto push_pop(T val) -> T {
+    if (_buf.is_empty() || !(val < _buf[0])) {
+      return val;
+    }
+    mem::swap(val, _buf[0]);
+    this->sift_down(0, _buf.len());
+    return val;
+  }
+
+  // moves all of `other` in: sifting each new value up when there are few of them,
+  // heapifying everything again when that is cheaper
+  void append(List<T, A>& other) {
+    const auto old_len = _buf.len();
+    _buf.append(other);
+    if (_buf.len() - old_len > old_len / 2) {
+      this->rebuild();
+      return;
+    }
+    for (auto i = old_len; i < _buf.len(); ++i) {
+      this->sift_up(i);
+    }
+  }
+
+  void clear() {
+    _buf.clear();
+  }
+
+  // the values in ascending order, sorted in place
+  auto into_sorted() && -> List<T, A> {
+    for (auto end = _buf.len(); end > 1; --end) {
+      mem::swap(_buf[0], _buf[end - 1]);
+      this->sift_down(0, end - 1);
+    }
+    return mem::move(_buf);
+  }
+
+  // the values in heap order
+  auto into_list() && -> List<T, A> {
+    return mem::move(_buf);
+  }
+
+  // trait: fmt::Display
+  void fmt(auto& f) const {
+    _buf.fmt(f);
+  }
+
+ private:
+  void rebuild() {
+    const auto len = _buf.len();
+    for (auto pos = len < 2 ? 0UL : (len - 2) / D + 1; pos != 0; --pos) {
+      this->sift_down(pos - 1, len);
+    }
+  }
+
+  // the value at `pos` moves up while it is greater than its parent; the others move
+  // down into the hole it leaves instead of being swapped one level at a time
+  void sift_up(usize pos) {
+    const auto p = _buf.as_mut_ptr();
+    auto hole = ptr::read(p + pos);
+    while (pos != 0) {
+      const auto parent = (pos - 1) / D;
+      if (!(p[parent] < hole)) {
+        break;
+      }
+      ptr::write(p + pos, ptr::read(p + parent));
+      pos = parent;
+    }
+    ptr::write(p + pos, mem::move(hole));
+  }
+
+  // the value at `pos` moves down past its greatest child, within `[0, end)`
+  void sift_down(usize pos, usize end) {
+    const auto p = _buf.as_mut_ptr();
+    auto hole = ptr::read(p + pos);
+    for (auto child = pos * D + 1; child < end; child = pos * D + 1) {
+      auto best = child;
+      const auto last = cmp::min(child + D, end);
+      for (auto i = child + 1; i < last; ++i) {
+        best = p[best] < p[i] ? i : best;
+      }
+      if (!(hole < p[best])) {
+        break;
+      }
+      ptr::write(p + pos, ptr::read(p + best));
+      pos = best;
+    }
+    ptr::write(p + pos, mem::move(hole));
+  }
+};
+
+// A min-heap of ids `[0, n)` with priorities, where each id can be found, re-prioritized
+// or removed in O(log n). This is what a scheduler or Dijkstra needs: `decrease_key` when a
+// task's deadline moves earlier, instead of pushing duplicates and skipping stale ones.
+template <class P, usize D = 4, class A = alloc::Global>
+class IndexedHeap {
+  static_assert(D >= 2, "IndexedHeap: arity must be at least 2");
+  static constexpr u32 kNil = num::Int<u32>::MAX;
+
+  struct Entry {
+    P prio;
+    u32 id;
+  };
+
+  List<Entry, A> _heap{};
+  List<u32, A> _pos{};  // the heap position of each id, kNil if absent
+
+ public:
+  IndexedHeap() noexcept = default;
+
+  // room for ids `[0, capacity)` without reallocating
+  static auto with_capacity(usize capacity, A alloc = {}) -> IndexedHeap {
+    auto res = IndexedHeap{};
+    res._heap = List<Entry, A>::with_capacity(capacity, alloc);
+    res._pos = List<u32, A>::with_capacity(capacity, alloc);
+    return res;
+  }
+
+  auto len() const noexcept -> usize {
+    return _heap.len();
+  }
+
+  auto is_empty() const noexcept -> bool {
+    return _heap.is_empty();
+  }
+
+  auto contains(usize id) const noexcept -> bool {
+    return id < _pos.len() && _pos[id] != kNil;
+  }
+
+  auto priority(usize id) const noexcept -> Option<const P&> {
+    if (!this->contains(id)) {
+      return {};
+    }
+    return _heap[_pos[id]].prio;
+  }
+
+  // the id with the least priority
+  auto peek() const noexcept -> Option<Tuple<usize, const P&>> {
+    if (_heap.is_empty()) {
+      return {};
+    }
+    return Tuple<usize, const P&>{_heap[0].id, _heap[0].prio};
+  }
+
+ public:
+  // Inserts `id`, or changes its priority if it is already in the heap.
+  void push(usize id, P prio) {
+    if (this->contains(id)) {
+      this->update(id, mem::move(prio));
+      return;
+    }
+    sfc::assert_(id < kNil, "IndexedHeap::push: id({}) out of range", id);
+    if (id >= _pos.len()) {
+      _pos.resize(id + 1, kNil);
+    }
+    const auto pos = _heap.len();
+    _heap.push(Entry{mem::move(prio), u32(id)});
+    _pos[id] = u32(pos);
+    this->sift_up(pos);
+  }
+
+  // removes the id with the least priority
+  auto pop() -> Option<Tuple<usize, P>> {
+    if (_heap.is_empty()) {
+      return {};
+    }
+    auto top = this->take(0);
+    return Tuple<usize, P>{top.id, mem::move(top.prio)};
+  }
+
+  auto remove(usize id) -> Option<P> {
+    if (!this->contains(id)) {
+      return {};
+    }
+    return this->take(_pos[id]).prio;
+  }
+
+  // lowers the priority of `id`, which must be in the heap
+  void decrease_key(usize id, P prio) {
+    sfc::assert_(this->contains(id), "IndexedHeap::decrease_key: id({}) not in heap", id);
+    const auto pos = _pos[id];
+    sfc::assert_(!(_heap[pos].prio < prio), "IndexedHeap::decrease_key: priority would increase");
+    _heap[pos].prio = mem::move(prio);
+    this->sift_up(pos);
+  }
+
+  // sets the priority of `id`, which must be in the heap, in either direction
+  void update(usize id, P prio) {
+    sfc::assert_(this->contains(id), "IndexedHeap::update: id({}) not in heap", id);
+    const auto pos = _pos[id];
+    const auto up = prio < _heap[pos].prio;
+    _heap[pos].prio = mem::move(prio);
+    if (up) {
+      this->sift_up(pos);
+    } else {
+      this->sift_down(pos);
+    }
+  }
+
+  void clear() {
+    for (const auto& e : _heap.as_slice()) {
+      _pos[e.id] = kNil;
+    }
+    _heap.clear();
+  }
+
+  // trait: fmt::Display
+  void fmt(auto& f) const {
+    auto imp = f.debug_list();
+    for (const auto& e : _heap.as_slice()) {
+      imp.entry(Tuple<usize, const P&>{e.id, e.prio});
+    }
+  }
+
+ private:
+  auto take(usize pos) -> Entry {
+    const auto last = _heap.len() - 1;
+    if (pos != last) {
+      this->swap(pos, last);
+    }
+    auto res = _heap.pop().unwrap();
+    _pos[res.id] = kNil;
+    if (pos != last) {
+      this->sift_down(pos);
+      this->sift_up(pos);
+    }
+    return res;
+  }
+
+  void swap(usize i, usize j) {
+    mem::swap(_heap[i], _heap[j]);
+    _pos[_heap[i].id] = u32(i);
+    _pos[_heap[j].id] = u32(j);
+  }
+
+  void sift_up(usize pos) {
+    while (pos != 0) {
+      const auto parent = (pos - 1) / D;
+      if (!(_heap[pos].prio < _heap[parent].prio)) {
+        break;
+      }
+      this->swap(pos, parent);
+      pos = parent;
+    }
+  }
+
+  void sift_down(usize pos) {
+    const auto end = _heap.len();
+    for (auto child = pos * D + 1; child < end; child = pos * D + 1) {
+      auto best = child;
+      const auto last = cmp::min(child + D, end);
+      for (auto i = child + 1; i < last; ++i) {
+        best = _heap[i].prio < _heap[best].prio ? i : best;
+      }
+      if (!(_heap[best].prio < _heap[pos].prio)) {
+        break;
+      }
+      this->swap(pos, best);
+      pos = best;
+    }
+  }
+};
+
+}  // namespace sfc::collections::binary_heap
+
+namespace sfc::collections {
+using binary_heap::BinaryHeap;
+using binary_heap::IndexedHeap;
+}  // namespace sfc::collections
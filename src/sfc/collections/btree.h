@@ -0,0 +1,4 @@
+#pragma once
+
+#include "sfc/collections/btree/btree_map.h"
+#include "sfc/collections/btree/btree_set.h"
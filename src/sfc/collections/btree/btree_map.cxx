@@ -0,0 +1,148 @@
+#include "sfc/collections/btree/btree_map.h"
+#include "sfc/serde/json.h"
+#include "sfc/test/test.h"
+
+namespace sfc::collections::btree::test {
+
+// a fixed permutation of [0, n) for n a power of two
+static auto shuffled(u32 i, u32 n) -> u32 {
+  return (i * 2654435761U) & (n - 1);
+}
+
+SFC_TEST(btree_map_insert) {
+  auto m = BTreeMap<u32, u32>{};
+  for (auto i = 0U; i < 4096U; ++i) {
+    const auto k = shuffled(i, 4096);
+    sfc::assert_eq(m.insert(k, k * 10), None{});
+  }
+  sfc::assert_eq(m.len(), 4096U);
+  sfc::assert_eq(m.insert(7U, 0U), Option{70U});
+  sfc::assert_eq(m.get(7U), Option{0U});
+  sfc::assert_eq(m.get(4096U), None{});
+
+  // in-order iteration
+  auto next = 0U;
+  m.iter().for_each([&](const auto& item) {
+    sfc::assert_eq(item._0, next);
+    next += 1;
+  });
+  sfc::assert_eq(next, 4096U);
+
+  sfc::assert_eq(m.first()->_0, 0U);
+  sfc::assert_eq(m.last()->_0, 4095U);
+}
+
+SFC_TEST(btree_map_remove) {
+  auto m = BTreeMap<u32, u32>{};
+  for (auto i = 0U; i < 4096U; ++i) {
+    m.insert(i, i);
+  }
+  for (auto i = 0U; i < 4096U; ++i) {
+    const auto k = shuffled(i, 4096);
+    if (k % 3 != 0) {
+      sfc::assert_eq(m.remove(k), Option{k});
+    }
+  }
+  sfc::assert_eq(m.remove(1U), None{});
+  sfc::assert_eq(m.len(), 1366U);
+
+  auto next = 0U;
+  m.iter().for_each([&](const auto& item) {
+    sfc::assert_eq(item._0, next);
+    next += 3;
+  });
+
+  auto cnt = 0U;
+  while (auto item = m.pop_first()) {
+    sfc::assert_eq(item->_0, cnt * 3);
+    cnt += 1;
+  }
+  sfc::assert_eq(cnt, 1366U);
+  sfc::assert_eq(m.is_empty(), true);
+  sfc::assert_eq(m.first(), None{});
+}
+
+SFC_TEST(btree_map_range) {
+  auto m = BTreeMap<u32, u32>{};
+  for (auto i = 0U; i < 1000U; ++i) {
+    m.insert(i * 2, i);
+  }
+
+  auto sum = 0U;
+  m.range(11U, 21U).for_each([&](const auto& item) { sum += item._0; });
+  sfc::assert_eq(sum, 12U + 14U + 16U + 18U + 20U);
+
+  sfc::assert_eq(m.range(20U, 20U).next(), None{});
+  sfc::assert_eq(m.range(30U, 10U).next(), None{});
+  sfc::assert_eq(m.range(5000U, 10U).next(), None{});
+  sfc::assert_eq(m.range(5000U, 6000U).next(), None{});
+  sfc::assert_eq(m.range_from(1997U).next()->_0, 1998U);
+  sfc::assert_eq(m.range_from(1999U).next(), None{});
+  sfc::assert_eq(m.range(1990U, 5000U).count(), 5U);
+}
+
+SFC_TEST(btree_map_iter_mut) {
+  auto m = BTreeMap<u32, u32>{};
+  for (auto i = 0U; i < 100U; ++i) {
+    m.insert(i, i);
+  }
+  m.iter_mut().for_each([](auto item) { item._1 *= 2; });
+  sfc::assert_eq(m.get(42U), Option{84U});
+  sfc::assert_eq(m.pop_last()->_1, 198U);
+}
+
+SFC_TEST(btree_map_from_sorted) {
+  const u32 sizes[] = {0, 1, 30, 31, 32, 1000, 5000};
+  for (auto n : sizes) {
+    auto items = List<Tuple<u32, u32>>{};
+    for (auto i = 0U; i < n; ++i) {
+      items.push({i, i});
+      if (i % 7 == 0) {
+        items.push({i, i + 1});
+      }
+    }
+
+    auto m = BTreeMap<u32, u32>::from_sorted(items.iter_mut());
+    sfc::assert_eq(m.len(), usize{n});
+    for (auto i = 0U; i < n; ++i) {
+      sfc::assert_eq(m.get(i), Option{i % 7 == 0 ? i + 1 : i});
+    }
+
+    // the bulk-loaded tree keeps its shape under later updates
+    for (auto i = 0U; i < n; i += 2) {
+      sfc::assert_eq(m.remove(i).is_some(), true);
+    }
+    for (auto i = n; i < n + 100; ++i) {
+      m.insert(i, i);
+    }
+    sfc::assert_eq(m.len(), usize{n / 2 + 100});
+  }
+}
+
+SFC_TEST(btree_map_str_key) {
+  auto m = BTreeMap<String, u32>{};
+  m.insert(String::from("b"), 2);
+  m.insert(String::from("a"), 1);
+  m.insert(String::from("c"), 3);
+
+  sfc::assert_eq(m.get(Str{"a"}), Option{1U});
+  sfc::assert_eq(m.remove(Str{"c"}), Option{3U});
+  sfc::assert_eq(string::format("{}", m), R"({"a": 1, "b": 2})");
+}
+
+SFC_TEST(btree_map_serde) {
+  auto m = BTreeMap<String, u32>{};
+  m.insert(String::from("y"), 2);
+  m.insert(String::from("x"), 1);
+
+  const auto s = serde::json::to_string(m);
+  sfc::assert_eq(s, R"({"x":1,"y":2})");
+
+  auto des = serde::json::Deserializer{s};
+  auto res = BTreeMap<String, u32>::deserialize(des).unwrap();
+  sfc::assert_eq(res.len(), 2U);
+  sfc::assert_eq(res.get(Str{"x"}), Option{1U});
+  sfc::assert_eq(res.get(Str{"y"}), Option{2U});
+}
+
+}  // namespace sfc::collections::btree::test
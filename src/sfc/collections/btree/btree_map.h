@@ -0,0 +1,533 @@
+#pragma once
+
+#include "sfc/collections/btree/node.h"
+
+namespace sfc::collections::btree {
+
+// in-order walk over [_front, _back); a null `_back` runs to the end of the tree
+template <class K, class V, class R = const V>
+struct Iter : iter::Iterator<Tuple<const K&, R&>> {
+  Handle<K, V> _front;
+  Handle<K, V> _back;
+
+ public:
+  auto next() noexcept -> Option<Tuple<const K&, R&>> {
+    if (_front == _back) {
+      return {};
+    }
+    const auto cur = _front;
+    _front = cur.next();
+    return Tuple<const K&, R&>{cur.key(), cur.val()};
+  }
+};
+
+// An ordered map stored as a B-tree.
+// Every node holds up to 2*B-1 sorted keys, sized so one node is searched in a couple of cache lines.
+template <class K, class V>
+class BTreeMap {
+  using Leaf = LeafNode<K, V>;
+  using Inner = InnerNode<K, V>;
+  using Pos = Handle<K, V>;
+
+  static constexpr usize B = Leaf::B;
+  static constexpr usize CAP = Leaf::CAP;
+  static constexpr usize MIN_LEN = Leaf::MIN_LEN;
+
+  Leaf* _root = nullptr;
+  usize _height = 0;
+  usize _len = 0;
+
+ public:
+  BTreeMap() noexcept = default;
+
+  ~BTreeMap() noexcept {
+    this->clear();
+  }
+
+  BTreeMap(BTreeMap&& other) noexcept
+      : _root{mem::take(other._root)}, _height{mem::take(other._height)}, _len{mem::take(other._len)} {}
+
+  BTreeMap& operator=(BTreeMap&& other) noexcept {
+    if (this == &other) return *this;
+    mem::swap(_root, other._root);
+    mem::swap(_height, other._height);
+    mem::swap(_len, other._len);
+    return *this;
+  }
+
+  // Builds the tree bottom-up in O(n) from items (`Tuple<K, V>`) in ascending key order.
+  // Items are moved out of the iterator; for equal keys the last one wins.
+  static auto from_sorted(auto iter) -> BTreeMap {
+    auto res = BTreeMap{};
+    auto leaf = static_cast<Leaf*>(nullptr);
+    auto last = Pos{};
+    while (auto item = iter.next()) {
+      auto&& [key, val] = *item;
+      if (last.node && !(last.key() < key)) {
+        sfc::assert_(!(key < last.key()), "BTreeMap::from_sorted: input not sorted");
+        last.val() = mem::move(val);
+        continue;
+      }
+      last = res.push_back(leaf, mem::move(key), mem::move(val));
+      res._len += 1;
+    }
+    res.fix_right_border();
+    return res;
+  }
+
+  auto len() const noexcept -> usize {
+    return _len;
+  }
+
+  auto is_empty() const noexcept -> bool {
+    return _len == 0;
+  }
+
+ public:
+  auto contains_key(const auto& key) const noexcept -> bool {
+    return this->search(key).node != nullptr;
+  }
+
+  auto get(const auto& key) const noexcept -> Option<const V&> {
+    if (const auto pos = this->search(key); pos.node) {
+      return pos.val();
+    }
+    return {};
+  }
+
+  auto get_mut(const auto& key) noexcept -> Option<V&> {
+    if (const auto pos = this->search(key); pos.node) {
+      return pos.val();
+    }
+    return {};
+  }
+
+  auto first() const noexcept -> Option<Tuple<const K&, const V&>> {
+    if (_root == nullptr) {
+      return {};
+    }
+    const auto pos = Pos::first_in(_root, _height);
+    return Tuple<const K&, const V&>{pos.key(), pos.val()};
+  }
+
+  auto last() const noexcept -> Option<Tuple<const K&, const V&>> {
+    if (_root == nullptr) {
+      return {};
+    }
+    const auto pos = Pos::last_in(_root, _height);
+    return Tuple<const K&, const V&>{pos.key(), pos.val()};
+  }
+
+  auto insert(K key, V val) -> Option<V> {
+    if (_root == nullptr) {
+      _root = Leaf::create();
+      _height = 0;
+    }
+
+    auto node = _root;
+    auto height = _height;
+    while (true) {
+      const auto idx = node->lower_bound(key);
+      if (idx < node->len() && !(key < node->key(idx))) {
+        return mem::replace(node->val(idx), mem::move(val));
+      }
+      if (height == 0) {
+        this->insert_leaf(node, idx, mem::move(key), mem::move(val));
+        _len += 1;
+        return {};
+      }
+      node = Inner::from(node)->edge(idx);
+      height -= 1;
+    }
+  }
+
+  auto remove(const auto& key) -> Option<V> {
+    const auto pos = this->search(key);
+    if (!pos.node) {
+      return {};
+    }
+    auto item = this->remove_at(pos);
+    return mem::move(item._1);
+  }
+
+  auto pop_first() -> Option<Tuple<K, V>> {
+    if (_root == nullptr) {
+      return {};
+    }
+    return this->remove_at(Pos::first_in(_root, _height));
+  }
+
+  auto pop_last() -> Option<Tuple<K, V>> {
+    if (_root == nullptr) {
+      return {};
+    }
+    return this->remove_at(Pos::last_in(_root, _height));
+  }
+
+  void clear() {
+    if (_root == nullptr) {
+      return;
+    }
+    BTreeMap::drop_node(_root, _height);
+    _root = nullptr;
+    _height = 0;
+    _len = 0;
+  }
+
+ public:
+  auto iter() const noexcept -> Iter<K, V> {
+    return {{}, this->front(), {}};
+  }
+
+  auto iter_mut() noexcept -> Iter<K, V, V> {
+    return {{}, this->front(), {}};
+  }
+
+  // keys in [start, end)
+  auto range(const auto& start, const auto& end) const noexcept -> Iter<K, V> {
+    const auto back = this->lower_bound(end);
+    auto front = this->lower_bound(start);
+    // `start` past every key, or not below `end`: empty
+    if (!front.node || (back.node && !(front.key() < back.key()))) {
+      front = back;
+    }
+    return {{}, front, back};
+  }
+
+  // keys in [start, ..)
+  auto range_from(const auto& start) const noexcept -> Iter<K, V> {
+    return {{}, this->lower_bound(start), {}};
+  }
+
+ public:
+  // trait: fmt::Display
+  void fmt(auto& f) const {
+    auto imp = f.debug_map();
+    this->iter().for_each([&](const auto& item) { imp.entry(item._0, item._1); });
+  }
+
+  // trait: serde::Serialize
+  void serialize(auto& ser) const {
+    auto imp = ser.serialize_obj();
+    this->iter().for_each([&](const auto& item) { imp.serialize_entry(item._0, item._1); });
+  }
+
+  // trait: serde::Deserialize
+  template <class D>
+  static auto deserialize(D& des) {
+    auto visit = [&](auto& map) { return map.template collect<BTreeMap, K, V>(); };
+    return des.deserialize_obj(visit);
+  }
+
+ private:
+  auto front() const noexcept -> Pos {
+    if (_root == nullptr) {
+      return {};
+    }
+    return Pos::first_in(_root, _height);
+  }
+
+  template <class Q>
+  auto search(const Q& key) const noexcept -> Pos {
+    auto node = _root;
+    auto height = _height;
+    while (node != nullptr) {
+      const auto idx = node->lower_bound(key);
+      if (idx < node->len() && !(key < node->key(idx))) {
+        return Pos{node, height, idx};
+      }
+      if (height == 0) {
+        break;
+      }
+      node = Inner::from(node)->edge(idx);
+      height -= 1;
+    }
+    return {};
+  }
+
+  // the first position whose key is not less than `key`
+  template <class Q>
+  auto lower_bound(const Q& key) const noexcept -> Pos {
+    auto res = Pos{};
+    auto node = _root;
+    auto height = _height;
+    while (node != nullptr) {
+      const auto idx = node->lower_bound(key);
+      if (idx < node->len()) {
+        res = Pos{node, height, idx};
+        if (!(key < node->key(idx))) {
+          break;
+        }
+      }
+      if (height == 0) {
+        break;
+      }
+      node = Inner::from(node)->edge(idx);
+      height -= 1;
+    }
+    return res;
+  }
+
+  static void drop_node(Leaf* node, usize height) {
+    ptr::drop(node->keys(), node->len());
+    ptr::drop(node->vals(), node->len());
+    if (height == 0) {
+      Leaf::destroy(node);
+      return;
+    }
+
+    const auto inner = Inner::from(node);
+    for (auto i = 0UL; i <= inner->len(); ++i) {
+      BTreeMap::drop_node(inner->edge(i), height - 1);
+    }
+    Inner::destroy(inner);
+  }
+
+  static void insert_fit(Leaf* node, usize height, usize idx, K&& key, V&& val, Leaf* right) {
+    if (height == 0) {
+      node->insert_fit(idx, mem::move(key), mem::move(val));
+    } else {
+      Inner::from(node)->insert_fit(idx, mem::move(key), mem::move(val), right);
+    }
+  }
+
+  // insert into a leaf, splitting full nodes on the way up
+  void insert_leaf(Leaf* node, usize idx, K&& key, V&& val) {
+    auto right = static_cast<Leaf*>(nullptr);
+    for (auto height = 0UL;; ++height) {
+      if (node->len() < CAP) {
+        BTreeMap::insert_fit(node, height, idx, mem::move(key), mem::move(val), right);
+        return;
+      }
+
+      // the median moves up, the upper half moves to a new sibling
+      auto sibling = height == 0 ? Leaf::create() : Inner::create();
+      ptr::copy_nonoverlapping(node->keys() + B, sibling->keys(), CAP - B);
+      ptr::copy_nonoverlapping(node->vals() + B, sibling->vals(), CAP - B);
+      sibling->_len = u16(CAP - B);
+      if (height != 0) {
+        const auto inner = Inner::from(sibling);
+        ptr::copy_nonoverlapping(Inner::from(node)->_edges + B, inner->_edges, CAP + 1 - B);
+        inner->fix_edges(0, CAP - B);
+      }
+      auto mid_key = ptr::read(node->keys() + B - 1);
+      auto mid_val = ptr::read(node->vals() + B - 1);
+      node->_len = u16(B - 1);
+
+      if (idx < B) {
+        BTreeMap::insert_fit(node, height, idx, mem::move(key), mem::move(val), right);
+      } else {
+        BTreeMap::insert_fit(sibling, height, idx - B, mem::move(key), mem::move(val), right);
+      }
+
+      const auto parent = node->_parent;
+      if (parent == nullptr) {
+        const auto root = Inner::create();
+        root->set_edge(0, node);
+        root->insert_fit(0, mem::move(mid_key), mem::move(mid_val), sibling);
+        _root = root;
+        _height += 1;
+        return;
+      }
+      idx = node->_parent_idx;
+      key = mem::move(mid_key);
+      val = mem::move(mid_val);
+      right = sibling;
+      node = parent;
+    }
+  }
+
+  auto remove_at(Pos pos) -> Tuple<K, V> {
+    _len -= 1;
+    if (pos.height == 0) {
+      auto res = pos.node->remove_at(pos.idx);
+      this->fix_underflow(pos.node);
+      return res;
+    }
+
+    // an inner key trades places with its in-order predecessor, which always sits in a leaf
+    const auto pred = Pos::last_in(Inner::from(pos.node)->edge(pos.idx), pos.height - 1);
+    auto [pk, pv] = pred.node->remove_at(pred.idx);
+    auto key = mem::replace(pos.key(), mem::move(pk));
+    auto val = mem::replace(pos.val(), mem::move(pv));
+    this->fix_underflow(pred.node);
+    return {mem::move(key), mem::move(val)};
+  }
+
+  // restore the minimum fill of `node` by stealing from or merging with a sibling
+  void fix_underflow(Leaf* node) {
+    for (auto height = 0UL;; ++height) {
+      const auto parent = node->_parent;
+      if (parent == nullptr) {
+        if (node->len() == 0) {
+          this->pop_root(node);
+        }
+        return;
+      }
+      if (node->len() >= MIN_LEN) {
+        return;
+      }
+
+      const auto idx = usize{node->_parent_idx};
+      if (idx > 0 && parent->edge(idx - 1)->len() > MIN_LEN) {
+        BTreeMap::steal_left(parent, idx, 1, height);
+        return;
+      }
+      if (idx < parent->len() && parent->edge(idx + 1)->len() > MIN_LEN) {
+        BTreeMap::steal_right(parent, idx, height);
+        return;
+      }
+      BTreeMap::merge(parent, idx > 0 ? idx - 1 : idx, height);
+      node = parent;
+    }
+  }
+
+  void pop_root(Leaf* root) {
+    if (_height == 0) {
+      Leaf::destroy(root);
+      _root = nullptr;
+      return;
+    }
+    _root = Inner::from(root)->edge(0);
+    _root->_parent = nullptr;
+    _root->_parent_idx = 0;
+    _height -= 1;
+    Inner::destroy(Inner::from(root));
+  }
+
+  // move `cnt` entries from the left sibling through the parent into edge `idx`
+  static void steal_left(Inner* parent, usize idx, usize cnt, usize height) {
+    const auto left = parent->edge(idx - 1);
+    const auto right = parent->edge(idx);
+    const auto left_len = left->len() - cnt;
+    const auto right_len = right->len();
+
+    ptr::copy(right->keys(), right->keys() + cnt, right_len);
+    ptr::copy(right->vals(), right->vals() + cnt, right_len);
+    ptr::write(right->keys() + cnt - 1, mem::replace(parent->key(idx - 1), ptr::read(left->keys() + left_len)));
+    ptr::write(right->vals() + cnt - 1, mem::replace(parent->val(idx - 1), ptr::read(left->vals() + left_len)));
+    ptr::copy_nonoverlapping(left->keys() + left_len + 1, right->keys(), cnt - 1);
+    ptr::copy_nonoverlapping(left->vals() + left_len + 1, right->vals(), cnt - 1);
+
+    if (height != 0) {
+      const auto l = Inner::from(left);
+      const auto r = Inner::from(right);
+      ptr::copy(r->_edges, r->_edges + cnt, right_len + 1);
+      ptr::copy_nonoverlapping(l->_edges + left_len + 1, r->_edges, cnt);
+      r->fix_edges(0, right_len + cnt);
+    }
+    left->_len = u16(left_len);
+    right->_len = u16(right_len + cnt);
+  }
+
+  // move one entry from the right sibling through the parent into edge `idx`
+  static void steal_right(Inner* parent, usize idx, usize height) {
+    const auto left = parent->edge(idx);
+    const auto right = parent->edge(idx + 1);
+    const auto left_len = left->len();
+    const auto right_len = right->len() - 1;
+
+    ptr::write(left->keys() + left_len, mem::replace(parent->key(idx), ptr::read(right->keys())));
+    ptr::write(left->vals() + left_len, mem::replace(parent->val(idx), ptr::read(right->vals())));
+    ptr::copy(right->keys() + 1, right->keys(), right_len);
+    ptr::copy(right->vals() + 1, right->vals(), right_len);
+
+    if (height != 0) {
+      const auto l = Inner::from(left);
+      const auto r = Inner::from(right);
+      l->set_edge(left_len + 1, r->edge(0));
+      ptr::copy(r->_edges + 1, r->_edges, right_len + 1);
+      r->fix_edges(0, right_len);
+    }
+    left->_len = u16(left_len + 1);
+    right->_len = u16(right_len);
+  }
+
+  // fold edge `idx + 1` and the separating key into edge `idx`
+  static void merge(Inner* parent, usize idx, usize height) {
+    const auto left = parent->edge(idx);
+    const auto right = parent->edge(idx + 1);
+    const auto left_len = left->len();
+    const auto right_len = right->len();
+
+    auto [key, val] = parent->remove_at(idx);
+    ptr::copy(parent->_edges + idx + 2, parent->_edges + idx + 1, parent->len() - idx);
+    parent->fix_edges(idx + 1, parent->len());
+
+    ptr::write(left->keys() + left_len, mem::move(key));
+    ptr::write(left->vals() + left_len, mem::move(val));
+    ptr::copy_nonoverlapping(right->keys(), left->keys() + left_len + 1, right_len);
+    ptr::copy_nonoverlapping(right->vals(), left->vals() + left_len + 1, right_len);
+    left->_len = u16(left_len + 1 + right_len);
+
+    if (height == 0) {
+      Leaf::destroy(right);
+      return;
+    }
+    const auto l = Inner::from(left);
+    const auto r = Inner::from(right);
+    ptr::copy_nonoverlapping(r->_edges, l->_edges + left_len + 1, right_len + 1);
+    l->fix_edges(left_len + 1, left->len());
+    Inner::destroy(r);
+  }
+
+  // append past the current maximum; the right border may be left under-full
+  auto push_back(Leaf*& leaf, K&& key, V&& val) -> Pos {
+    if (leaf == nullptr) {
+      _root = leaf = Leaf::create();
+      _height = 0;
+    }
+    if (leaf->len() < CAP) {
+      const auto idx = leaf->len();
+      leaf->insert_fit(idx, mem::move(key), mem::move(val));
+      return Pos{leaf, 0, idx};
+    }
+
+    // climb to the lowest ancestor with room, or grow a new root
+    auto open = leaf->_parent;
+    auto height = 1UL;
+    while (open != nullptr && open->len() == CAP) {
+      open = open->_parent;
+      height += 1;
+    }
+    if (open == nullptr) {
+      open = Inner::create();
+      open->set_edge(0, _root);
+      _root = open;
+      _height += 1;
+      height = _height;
+    }
+
+    // hang an empty right spine below the new key
+    leaf = Leaf::create();
+    auto spine = leaf;
+    for (auto i = 1UL; i < height; ++i) {
+      const auto inner = Inner::create();
+      inner->set_edge(0, spine);
+      spine = inner;
+    }
+    const auto idx = open->len();
+    open->insert_fit(idx, mem::move(key), mem::move(val), spine);
+    return Pos{open, height, idx};
+  }
+
+  // top up the right border after `push_back`, its left siblings are all full
+  void fix_right_border() {
+    auto node = _root;
+    for (auto height = _height; height != 0; --height) {
+      const auto inner = Inner::from(node);
+      const auto idx = inner->len();
+      const auto last = inner->edge(idx);
+      if (last->len() < MIN_LEN) {
+        BTreeMap::steal_left(inner, idx, MIN_LEN - last->len(), height - 1);
+      }
+      node = last;
+    }
+  }
+};
+
+}  // namespace sfc::collections::btree
+
+namespace sfc::collections {
+using btree::BTreeMap;
+}
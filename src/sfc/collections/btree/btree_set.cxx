@@ -0,0 +1,68 @@
+#include "sfc/collections/btree/btree_set.h"
+#include "sfc/serde/json.h"
+#include "sfc/test/test.h"
+
+namespace sfc::collections::btree::test {
+
+SFC_TEST(btree_set_insert) {
+  auto s = BTreeSet<i32>{};
+  for (auto i = 0; i < 1000; ++i) {
+    sfc::assert_eq(s.insert((i * 37) % 1000 - 500), true);
+  }
+  sfc::assert_eq(s.insert(0), false);
+  sfc::assert_eq(s.len(), 1000U);
+  sfc::assert_eq(s.contains(-500), true);
+  sfc::assert_eq(s.contains(500), false);
+  sfc::assert_eq(s.first(), Option{-500});
+  sfc::assert_eq(s.last(), Option{499});
+
+  sfc::assert_eq(s.remove(-500), true);
+  sfc::assert_eq(s.remove(-500), false);
+  sfc::assert_eq(s.pop_first(), Option{-499});
+  sfc::assert_eq(s.pop_last(), Option{499});
+  sfc::assert_eq(s.len(), 997U);
+}
+
+SFC_TEST(btree_set_range) {
+  auto s = BTreeSet<u32>{};
+  for (auto i = 0U; i < 100U; ++i) {
+    s.insert(i * 10);
+  }
+  auto it = s.range(15U, 45U);
+  sfc::assert_eq(it.next(), Option{20U});
+  sfc::assert_eq(it.next(), Option{30U});
+  sfc::assert_eq(it.next(), Option{40U});
+  sfc::assert_eq(it.next(), None{});
+  sfc::assert_eq(s.range_from(985U).next(), Option{990U});
+}
+
+SFC_TEST(btree_set_from_sorted) {
+  auto vals = List<u32>{};
+  for (auto i = 0U; i < 2000U; ++i) {
+    vals.push(i / 2);
+  }
+  auto s = BTreeSet<u32>::from_sorted(vals.iter());
+  sfc::assert_eq(s.len(), 1000U);
+
+  auto next = 0U;
+  s.iter().for_each([&](u32 val) {
+    sfc::assert_eq(val, next);
+    next += 1;
+  });
+}
+
+SFC_TEST(btree_set_fmt) {
+  auto s = BTreeSet<u32>{};
+  s.insert(3);
+  s.insert(1);
+  s.insert(2);
+  sfc::assert_eq(string::format("{}", s), "{1, 2, 3}");
+  sfc::assert_eq(serde::json::to_string(s), "[1,2,3]");
+
+  auto des = serde::json::Deserializer{Str{"[5,4,5]"}};
+  auto res = BTreeSet<u32>::deserialize(des).unwrap();
+  sfc::assert_eq(res.len(), 2U);
+  sfc::assert_eq(res.first(), Option{4U});
+}
+
+}  // namespace sfc::collections::btree::test
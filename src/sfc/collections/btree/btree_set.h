@@ -0,0 +1,131 @@
+#pragma once
+
+#include "sfc/collections/btree/btree_map.h"
+
+namespace sfc::collections::btree {
+
+template <class T>
+struct SetIter : iter::Iterator<const T&> {
+  Iter<T, Unit> _inn;
+
+ public:
+  auto next() noexcept -> Option<const T&> {
+    if (auto item = _inn.next()) {
+      return item->_0;
+    }
+    return {};
+  }
+};
+
+// An ordered set, a `BTreeMap` without values.
+template <class T>
+class BTreeSet {
+  BTreeMap<T, Unit> _inn{};
+
+ public:
+  BTreeSet() noexcept = default;
+
+  // Builds the set in O(n) from values in ascending order; duplicates collapse into one.
+  static auto from_sorted(auto iter) -> BTreeSet {
+    auto items = iter.map([](auto&& val) { return Tuple<T, Unit>{mem::move(val), {}}; });
+    auto res = BTreeSet{};
+    res._inn = BTreeMap<T, Unit>::from_sorted(mem::move(items));
+    return res;
+  }
+
+  auto len() const noexcept -> usize {
+    return _inn.len();
+  }
+
+  auto is_empty() const noexcept -> bool {
+    return _inn.is_empty();
+  }
+
+ public:
+  auto contains(const auto& val) const noexcept -> bool {
+    return _inn.contains_key(val);
+  }
+
+  // Returns whether the value was newly inserted.
+  auto insert(T val) -> bool {
+    return !_inn.insert(mem::move(val), {});
+  }
+
+  // Returns whether the value was present in the set.
+  auto remove(const auto& val) -> bool {
+    return bool(_inn.remove(val));
+  }
+
+  auto first() const noexcept -> Option<const T&> {
+    if (auto item = _inn.first()) {
+      return item->_0;
+    }
+    return {};
+  }
+
+  auto last() const noexcept -> Option<const T&> {
+    if (auto item = _inn.last()) {
+      return item->_0;
+    }
+    return {};
+  }
+
+  auto pop_first() -> Option<T> {
+    if (auto item = _inn.pop_first()) {
+      return mem::move(item->_0);
+    }
+    return {};
+  }
+
+  auto pop_last() -> Option<T> {
+    if (auto item = _inn.pop_last()) {
+      return mem::move(item->_0);
+    }
+    return {};
+  }
+
+  void clear() {
+    _inn.clear();
+  }
+
+ public:
+  auto iter() const noexcept -> SetIter<T> {
+    return {{}, _inn.iter()};
+  }
+
+  // values in [start, end)
+  auto range(const auto& start, const auto& end) const noexcept -> SetIter<T> {
+    return {{}, _inn.range(start, end)};
+  }
+
+  // values in [start, ..)
+  auto range_from(const auto& start) const noexcept -> SetIter<T> {
+    return {{}, _inn.range_from(start)};
+  }
+
+ public:
+  // trait: fmt::Display
+  void fmt(auto& f) const {
+    auto imp = f.debug_set();
+    this->iter().for_each([&](const T& val) { imp.entry(val); });
+  }
+
+  // trait: serde::Serialize
+  void serialize(auto& ser) const {
+    auto imp = ser.serialize_seq();
+    this->iter().for_each([&](const T& val) { imp.serialize_element(val); });
+  }
+
+  // trait: serde::Deserialize
+  template <class D>
+  static auto deserialize(D& des) {
+    auto visit = [&](auto& seq) { return seq.template collect<BTreeSet, T>(); };
+    return des.deserialize_seq(visit);
+  }
+};
+
+}  // namespace sfc::collections::btree
+
+namespace sfc::collections {
+using btree::BTreeSet;
+}
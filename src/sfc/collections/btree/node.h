@@ -0,0 +1,197 @@
+#pragma once
+
+#include "sfc/alloc/alloc.h"
+
+namespace sfc::collections::btree {
+
+// keys of one node span about two cache lines, small enough for a linear search
+template <class K>
+consteval auto node_branch() -> usize {
+  const auto b = 128 / sizeof(K);
+  return b < 4 ? 4 : b > 16 ? 16 : b;
+}
+
+template <class K, class V>
+struct InnerNode;
+
+template <class K, class V>
+struct LeafNode {
+  static constexpr usize B = node_branch<K>();
+  static constexpr usize CAP = 2 * B - 1;
+  static constexpr usize MIN_LEN = B - 1;
+
+  InnerNode<K, V>* _parent;
+  u16 _parent_idx;
+  u16 _len;
+  alignas(K) u8 _keys[CAP * sizeof(K)];
+  alignas(V) u8 _vals[CAP * sizeof(V)];
+
+ public:
+  static auto create() -> LeafNode* {
+    auto res = static_cast<LeafNode*>(alloc::Global::allocate(mem::Layout::of<LeafNode>()));
+    res->_parent = nullptr;
+    res->_parent_idx = 0;
+    res->_len = 0;
+    return res;
+  }
+
+  static void destroy(LeafNode* node) {
+    alloc::Global::deallocate(node, mem::Layout::of<LeafNode>());
+  }
+
+  auto len() const noexcept -> usize {
+    return _len;
+  }
+
+  auto keys() const noexcept -> K* {
+    return ptr::cast<K>(ptr::cast_mut(_keys));
+  }
+
+  auto vals() const noexcept -> V* {
+    return ptr::cast<V>(ptr::cast_mut(_vals));
+  }
+
+  auto key(usize idx) const noexcept -> K& {
+    return this->keys()[idx];
+  }
+
+  auto val(usize idx) const noexcept -> V& {
+    return this->vals()[idx];
+  }
+
+  // the first slot whose key is not less than `key`
+  auto lower_bound(const auto& key) const noexcept -> usize {
+    const auto ks = this->keys();
+    auto idx = 0UL;
+    while (idx < _len && ks[idx] < key) {
+      ++idx;
+    }
+    return idx;
+  }
+
+  void insert_fit(usize idx, K&& key, V&& val) noexcept {
+    ptr::copy(this->keys() + idx, this->keys() + idx + 1, _len - idx);
+    ptr::copy(this->vals() + idx, this->vals() + idx + 1, _len - idx);
+    ptr::write(this->keys() + idx, mem::move(key));
+    ptr::write(this->vals() + idx, mem::move(val));
+    _len += 1;
+  }
+
+  auto remove_at(usize idx) noexcept -> Tuple<K, V> {
+    auto key = ptr::read(this->keys() + idx);
+    auto val = ptr::read(this->vals() + idx);
+    ptr::copy(this->keys() + idx + 1, this->keys() + idx, _len - idx - 1);
+    ptr::copy(this->vals() + idx + 1, this->vals() + idx, _len - idx - 1);
+    _len -= 1;
+    return {mem::move(key), mem::move(val)};
+  }
+};
+
+template <class K, class V>
+struct InnerNode : LeafNode<K, V> {
+  using Leaf = LeafNode<K, V>;
+  Leaf* _edges[Leaf::CAP + 1];
+
+ public:
+  static auto create() -> InnerNode* {
+    auto res = static_cast<InnerNode*>(alloc::Global::allocate(mem::Layout::of<InnerNode>()));
+    res->_parent = nullptr;
+    res->_parent_idx = 0;
+    res->_len = 0;
+    return res;
+  }
+
+  static void destroy(InnerNode* node) {
+    alloc::Global::deallocate(node, mem::Layout::of<InnerNode>());
+  }
+
+  static auto from(Leaf* node) noexcept -> InnerNode* {
+    return static_cast<InnerNode*>(node);
+  }
+
+  auto edge(usize idx) const noexcept -> Leaf* {
+    return _edges[idx];
+  }
+
+  void set_edge(usize idx, Leaf* child) noexcept {
+    _edges[idx] = child;
+    child->_parent = this;
+    child->_parent_idx = u16(idx);
+  }
+
+  // re-link the children in [start, end] after they moved
+  void fix_edges(usize start, usize end) noexcept {
+    for (auto i = start; i <= end; ++i) {
+      this->set_edge(i, _edges[i]);
+    }
+  }
+
+  // `right` becomes the edge after the new key
+  void insert_fit(usize idx, K&& key, V&& val, Leaf* right) noexcept {
+    Leaf::insert_fit(idx, mem::move(key), mem::move(val));
+    ptr::copy(_edges + idx + 1, _edges + idx + 2, this->_len - idx - 1);
+    _edges[idx + 1] = right;
+    this->fix_edges(idx + 1, this->_len);
+  }
+};
+
+// a key/value position inside the tree; a null node is the end position
+template <class K, class V>
+struct Handle {
+  using Leaf = LeafNode<K, V>;
+  using Inner = InnerNode<K, V>;
+
+  Leaf* node = nullptr;
+  usize height = 0;
+  usize idx = 0;
+
+ public:
+  auto operator==(const Handle& other) const noexcept -> bool {
+    return node == other.node && idx == other.idx;
+  }
+
+  auto key() const noexcept -> K& {
+    return node->key(idx);
+  }
+
+  auto val() const noexcept -> V& {
+    return node->val(idx);
+  }
+
+  static auto first_in(Leaf* node, usize height) noexcept -> Handle {
+    for (; height != 0; --height) {
+      node = Inner::from(node)->edge(0);
+    }
+    return Handle{node, 0, 0};
+  }
+
+  static auto last_in(Leaf* node, usize height) noexcept -> Handle {
+    for (; height != 0; --height) {
+      node = Inner::from(node)->edge(node->len());
+    }
+    return Handle{node, 0, node->len() - 1};
+  }
+
+  // the in-order successor, or the end position
+  auto next() const noexcept -> Handle {
+    if (height != 0) {
+      return Handle::first_in(Inner::from(node)->edge(idx + 1), height - 1);
+    }
+    if (idx + 1 < node->len()) {
+      return Handle{node, 0, idx + 1};
+    }
+
+    auto cur = node;
+    auto h = 0UL;
+    while (auto parent = cur->_parent) {
+      h += 1;
+      if (cur->_parent_idx < parent->len()) {
+        return Handle{parent, h, cur->_parent_idx};
+      }
+      cur = parent;
+    }
+    return Handle{};
+  }
+};
+
+}  // namespace sfc::collections::btree
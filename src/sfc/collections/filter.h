@@ -0,0 +1,4 @@
+#pragma once
+
+#include "sfc/collections/filter/bloom_filter.h"
+#include "sfc/collections/filter/cuckoo_filter.h"
@@ -0,0 +1,93 @@
+#include "sfc/collections/filter/bloom_filter.h"
+#include "sfc/env.h"
+#include "sfc/serde/json.h"
+#include "sfc/test/test.h"
+
+namespace sfc::collections::filter::test {
+
+SFC_TEST(bloom_simple) {
+  auto f = BloomFilter<>::with_capacity(1000);
+  sfc::assert_eq(f.contains(1U), false);
+
+  for (auto i = 0U; i < 1000U; ++i) {
+    f.insert(i);
+  }
+  for (auto i = 0U; i < 1000U; ++i) {
+    sfc::assert_eq(f.contains(i), true);
+  }
+  sfc::assert_eq(f.contains(Str{"x"}), f.contains(String::from("x")));
+
+  f.clear();
+  sfc::assert_eq(f.contains(1U), false);
+  sfc::assert_eq(f.fill_ratio(), 0.0);
+}
+
+SFC_TEST(bloom_fp_rate) {
+  static constexpr auto kCount = 10000U;
+  auto f = BloomFilter<>::with_capacity(kCount, 0.01);
+  for (auto i = 0U; i < kCount; ++i) {
+    f.insert(i);
+  }
+
+  auto fps = 0U;
+  for (auto i = kCount; i < kCount * 11; ++i) {
+    fps += f.contains(i);
+  }
+  // blocking costs some accuracy: about 1.3% at the ~9.6 bits per key sized for 1%
+  sfc::assert_lt(fps, kCount * 10 * 3 / 100);
+}
+
+SFC_TEST(bloom_merge) {
+  auto a = BloomFilter<>{16};
+  auto b = BloomFilter<>{16};
+  a.insert(Str{"a"});
+  b.insert(Str{"b"});
+  a.merge(b);
+  sfc::assert_eq(a.contains(Str{"a"}), true);
+  sfc::assert_eq(a.contains(Str{"b"}), true);
+}
+
+SFC_TEST(bloom_serde) {
+  auto f = BloomFilter<>::with_capacity(100);
+  for (auto i = 0U; i < 100U; ++i) {
+    f.insert(i * 7);
+  }
+
+  const auto s = serde::json::to_string(f);
+  auto des = serde::json::Deserializer{s};
+  const auto g = BloomFilter<>::deserialize(des).unwrap();
+  sfc::assert_eq(g.num_blocks(), f.num_blocks());
+  sfc::assert_eq(g.as_bytes() == f.as_bytes(), true);
+
+  const auto h = BloomFilter<>::from_bytes(f.as_bytes());
+  for (auto i = 0U; i < 100U; ++i) {
+    sfc::assert_eq(g.contains(i * 7), true);
+    sfc::assert_eq(h.contains(i * 7), true);
+  }
+}
+
+SFC_TEST(bloom_mmap) {
+  const auto path_buf = env::temp_dir().join(fs::Path{"test_bloom_filter.bin"});
+  const auto path = path_buf.as_path();
+
+  auto f = BloomFilter<>::with_capacity(1000);
+  for (auto i = 0U; i < 1000U; ++i) {
+    f.insert(i * 7);
+  }
+  sfc::assert_eq(f.write(path).is_ok(), true);
+
+  {
+    const auto v = BloomFilter<>::View::open(path).unwrap();
+    for (auto i = 0U; i < 1000U; ++i) {
+      sfc::assert_eq(v.contains(i * 7), true);
+      sfc::assert_eq(v.contains(i * 7 + 1), f.contains(i * 7 + 1));
+    }
+  }
+  (void)fs::remove_file(path);
+
+  // the view borrows the blocks, which must be aligned to one
+  sfc::assert_eq(BloomFilter<>::View::from_bytes(f.as_bytes()).unwrap().contains(7U), true);
+  sfc::assert_eq(BloomFilter<>::View::from_bytes(f.as_bytes()[{1, 65}]).is_err(), true);
+}
+
+}  // namespace sfc::collections::filter::test
@@ -0,0 +1,242 @@
+#pragma once
+
+#include "sfc/alloc/buffer.h"
+#include "sfc/fs.h"
+#include "sfc/serde/base64.h"
+
+namespace sfc::collections::filter {
+
+// A split-block Bloom filter: each key maps to one 64-byte block and sets one bit in each of
+// its eight 64-bit lanes, so a lookup touches a single cache line and the lanes can be tested
+// in parallel. Blocking trades a little accuracy for that locality.
+// A filter is only meaningful with the hasher it was built with, including after a round trip.
+template <class H = BuildHasher<>>
+class BloomFilter {
+ public:
+  static constexpr usize kLanes = 8;
+  static constexpr usize kBlockBits = kLanes * 64;
+
+  struct alignas(64) Block {
+    u64 lanes[kLanes];
+  };
+
+  class View;
+
+ private:
+  // odd multipliers, one per lane, that spread the low hash half over 6-bit bit positions
+  static constexpr u32 kSalts[kLanes] = {
+      0x47b6137bU, 0x44974d91U, 0x8824ad5bU, 0xa2b7289dU, 0x705495c7U, 0x2df1424bU, 0x9efc4947U, 0x5c6bfb31U,
+  };
+
+  Buffer<Block> _blocks{};
+  [[no_unique_address]] H _hash{};
+
+ public:
+  BloomFilter() noexcept = default;
+
+  explicit BloomFilter(usize num_blocks, H hash = {})
+      : _blocks{Buffer<Block>::with_capacity_zeroed(cmp::max(num_blocks, usize{1}))}, _hash{mem::move(hash)} {}
+
+  // sized for `items` keys at a false positive rate of about `fp_rate`
+  static auto with_capacity(usize items, f64 fp_rate = 0.01, H hash = {}) -> BloomFilter {
+    sfc::assert_(fp_rate > 0.0 && fp_rate < 1.0, "BloomFilter::with_capacity: fp_rate({}) out of range", fp_rate);
+    constexpr auto kLn2Sq = 0.4804530139182014;
+    const auto bits = f64(items) * -__builtin_log(fp_rate) / kLn2Sq;
+    return BloomFilter{usize(bits / kBlockBits) + 1, mem::move(hash)};
+  }
+
+  // the raw blocks, as written by `as_bytes`; trailing bytes short of a whole block are ignored
+  static auto from_bytes(Slice<const u8> bytes, H hash = {}) -> BloomFilter {
+    auto res = BloomFilter{bytes.len() / sizeof(Block), mem::move(hash)};
+    res.load_bytes(bytes);
+    return res;
+  }
+
+  auto num_blocks() const noexcept -> usize {
+    return _blocks.cap();
+  }
+
+  auto num_bits() const noexcept -> usize {
+    return _blocks.cap() * kBlockBits;
+  }
+
+  // the blocks as they lie in memory, for persisting; lanes are in native byte order
+  auto as_bytes() const noexcept -> Slice<const u8> {
+    return _blocks.as_bytes();
+  }
+
+  // the blocks as a file, to map back with `View::open`
+  auto write(fs::Path path) const -> io::Result<> {
+    return fs::write(path, this->as_bytes());
+  }
+
+  // the share of set bits, a proxy for the current false positive rate
+  auto fill_ratio() const noexcept -> f64 {
+    if (_blocks.cap() == 0) {
+      return 0.0;
+    }
+    auto ones = 0UL;
+    for (auto i = 0UL; i < _blocks.cap(); ++i) {
+      for (auto lane : _blocks[i].lanes) {
+        ones += usize(__builtin_popcountll(lane));
+      }
+    }
+    return f64(ones) / f64(this->num_bits());
+  }
+
+ public:
+  void insert(const auto& key) noexcept {
+    this->insert_hash(_hash.hash_one(key));
+  }
+
+  // false: `key` was never inserted; true: it probably was
+  auto contains(const auto& key) const noexcept -> bool {
+    return this->contains_hash(_hash.hash_one(key));
+  }
+
+  void insert_hash(u64 hx) noexcept {
+    if (_blocks.cap() == 0) {
+      return;
+    }
+    auto& blk = _blocks[BloomFilter::block_of(hx, _blocks.cap())];
+    for (auto i = 0UL; i < kLanes; ++i) {
+      blk.lanes[i] |= BloomFilter::lane_bit(hx, i);
+    }
+  }
+
+  auto contains_hash(u64 hx) const noexcept -> bool {
+    return BloomFilter::probe(_blocks.ptr(), _blocks.cap(), hx);
+  }
+
+  // the union of two filters of the same size and hasher
+  void merge(const BloomFilter& other) noexcept {
+    sfc::assert_eq(_blocks.cap(), other._blocks.cap());
+    for (auto i = 0UL; i < _blocks.cap(); ++i) {
+      for (auto j = 0UL; j < kLanes; ++j) {
+        _blocks[i].lanes[j] |= other._blocks[i].lanes[j];
+      }
+    }
+  }
+
+  void clear() noexcept {
+    ptr::write_bytes(_blocks.ptr(), 0U, _blocks.cap());
+  }
+
+ public:
+  // trait: fmt::Display
+  void fmt(auto& f) const {
+    f.debug_struct("BloomFilter").field("blocks", this->num_blocks()).field("fill_ratio", this->fill_ratio());
+  }
+
+  // trait: serde::Serialize
+  void serialize(auto& ser) const {
+    auto imp = ser.serialize_obj();
+    imp.serialize_entry("blocks", this->num_blocks());
+    imp.serialize_entry("bits", serde::base64::encode(this->as_bytes()));
+  }
+
+  // trait: serde::Deserialize
+  template <class D>
+  static auto deserialize(D& des) {
+    auto visit = [&](auto& obj) -> decltype(obj.template next_val<BloomFilter>()) {
+      auto blocks = 0UL;
+      auto bytes = List<u8>{};
+      while (auto key = _TRY(obj.next_key())) {
+        if (*key == "blocks") {
+          blocks = _TRY(obj.template next_val<usize>());
+        } else if (*key == "bits") {
+          bytes = serde::base64::decode(_TRY(obj.template next_val<Str>()));
+        }
+      }
+      auto res = BloomFilter{blocks};
+      res.load_bytes(bytes.as_slice());
+      return res;
+    };
+    return des.deserialize_obj(visit);
+  }
+
+ private:
+  void load_bytes(Slice<const u8> bytes) noexcept {
+    const auto cnt = cmp::min(bytes.len(), _blocks.cap() * sizeof(Block));
+    ptr::copy_nonoverlapping(bytes.as_ptr(), ptr::cast<u8>(_blocks.ptr()), cnt);
+  }
+
+  static auto probe(const Block* blocks, usize cnt, u64 hx) noexcept -> bool {
+    if (cnt == 0) {
+      return false;
+    }
+    // no early exit, so the loop stays branch-free and vectorizable
+    const auto& blk = blocks[BloomFilter::block_of(hx, cnt)];
+    auto miss = u64{0};
+    for (auto i = 0UL; i < kLanes; ++i) {
+      const auto bit = BloomFilter::lane_bit(hx, i);
+      miss |= (blk.lanes[i] & bit) ^ bit;
+    }
+    return miss == 0;
+  }
+
+  // the high half picks the block (multiply-shift instead of a modulo), the low half the bits
+  static auto block_of(u64 hx, usize cnt) noexcept -> usize {
+    return usize(((hx >> 32) * cnt) >> 32);
+  }
+
+  static auto lane_bit(u64 hx, usize lane) noexcept -> u64 {
+    return u64{1} << ((u32(hx) * kSalts[lane]) >> 26);
+  }
+};
+
+// A read-only `BloomFilter` over blocks it does not copy: a mapped file, or bytes the caller keeps
+// alive. `open` maps the file; only the blocks a lookup touches are read.
+template <class H>
+class BloomFilter<H>::View {
+  fs::Mmap _map{};
+  const Block* _blocks = nullptr;
+  usize _cnt = 0;
+  [[no_unique_address]] H _hash{};
+
+ public:
+  View() noexcept = default;
+
+  static auto open(fs::Path path, H hash = {}) -> io::Result<View> {
+    auto res = View{};
+    res._map = _TRY(fs::Mmap::open(path));
+    _TRY(res.load(res._map.as_bytes(), mem::move(hash)));
+    return {mem::move(res)};
+  }
+
+  // borrows `bytes`, which must be aligned to a block; trailing bytes short of a block are ignored
+  static auto from_bytes(Slice<const u8> bytes, H hash = {}) -> io::Result<View> {
+    auto res = View{};
+    _TRY(res.load(bytes, mem::move(hash)));
+    return {mem::move(res)};
+  }
+
+  auto num_blocks() const noexcept -> usize {
+    return _cnt;
+  }
+
+  auto contains(const auto& key) const noexcept -> bool {
+    return BloomFilter::probe(_blocks, _cnt, _hash.hash_one(key));
+  }
+
+  auto contains_hash(u64 hx) const noexcept -> bool {
+    return BloomFilter::probe(_blocks, _cnt, hx);
+  }
+
+ private:
+  auto load(Slice<const u8> bytes, H hash) -> io::Result<> {
+    if (reinterpret_cast<usize>(bytes.as_ptr()) % alignof(Block) != 0) {
+      return {io::Error::InvalidData};
+    }
+    _blocks = ptr::cast<const Block>(bytes.as_ptr());
+    _cnt = bytes.len() / sizeof(Block);
+    _hash = mem::move(hash);
+    return Ok{};
+  }
+};
+
+}  // namespace sfc::collections::filter
+
+namespace sfc::collections {
+using filter::BloomFilter;
+}  // namespace sfc::collections
@@ -0,0 +1,109 @@
+#include "sfc/collections/filter/cuckoo_filter.h"
+#include "sfc/env.h"
+#include "sfc/serde/json.h"
+#include "sfc/test/test.h"
+
+namespace sfc::collections::filter::test {
+
+SFC_TEST(cuckoo_simple) {
+  auto f = CuckooFilter<>::with_capacity(1000);
+  sfc::assert_eq(f.is_empty(), true);
+
+  for (auto i = 0U; i < 1000U; ++i) {
+    sfc::assert_eq(f.insert(i), true);
+  }
+  sfc::assert_eq(f.len(), 1000U);
+  for (auto i = 0U; i < 1000U; ++i) {
+    sfc::assert_eq(f.contains(i), true);
+  }
+
+  for (auto i = 0U; i < 1000U; i += 2) {
+    sfc::assert_eq(f.remove(i), true);
+  }
+  sfc::assert_eq(f.len(), 500U);
+  for (auto i = 1U; i < 1000U; i += 2) {
+    sfc::assert_eq(f.contains(i), true);
+  }
+
+  f.clear();
+  sfc::assert_eq(f.contains(1U), false);
+}
+
+SFC_TEST(cuckoo_fp_rate) {
+  static constexpr auto kCount = 10000U;
+  auto f = CuckooFilter<>::with_capacity(kCount);
+  for (auto i = 0U; i < kCount; ++i) {
+    f.insert(i);
+  }
+
+  auto fps = 0U;
+  for (auto i = kCount; i < kCount * 11; ++i) {
+    fps += f.contains(i);
+  }
+  sfc::assert_eq(fps < kCount * 10 / 1000, true);
+}
+
+SFC_TEST(cuckoo_full) {
+  auto f = CuckooFilter<>{4};
+  sfc::assert_eq(f.capacity(), 16U);
+
+  auto cnt = 0U;
+  while (f.insert(cnt)) {
+    cnt += 1;
+  }
+  // the key whose insert failed is still reported present
+  sfc::assert_eq(f.contains(cnt), true);
+  sfc::assert_eq(f.len(), usize{cnt + 1});
+  sfc::assert_eq(f.insert(cnt + 1), false);
+
+  for (auto i = 0U; i <= cnt; ++i) {
+    sfc::assert_eq(f.contains(i), true);
+  }
+  sfc::assert_eq(f.remove(cnt), true);
+  sfc::assert_eq(f.len(), usize{cnt});
+}
+
+SFC_TEST(cuckoo_serde) {
+  auto f = CuckooFilter<>::with_capacity(100);
+  for (auto i = 0U; i < 100U; ++i) {
+    f.insert(i * 3);
+  }
+
+  const auto s = serde::json::to_string(f);
+  auto des = serde::json::Deserializer{s};
+  const auto g = CuckooFilter<>::deserialize(des).unwrap();
+  sfc::assert_eq(g.len(), f.len());
+
+  const auto h = CuckooFilter<>::from_bytes(f.as_bytes());
+  sfc::assert_eq(h.len(), f.len());
+  for (auto i = 0U; i < 100U; ++i) {
+    sfc::assert_eq(g.contains(i * 3), true);
+    sfc::assert_eq(h.contains(i * 3), true);
+  }
+}
+
+SFC_TEST(cuckoo_mmap) {
+  const auto path_buf = env::temp_dir().join(fs::Path{"test_cuckoo_filter.bin"});
+  const auto path = path_buf.as_path();
+
+  auto f = CuckooFilter<>::with_capacity(1000);
+  for (auto i = 0U; i < 1000U; ++i) {
+    f.insert(i * 3);
+  }
+  sfc::assert_eq(f.write(path).is_ok(), true);
+
+  {
+    const auto v = CuckooFilter<>::View::open(path).unwrap();
+    for (auto i = 0U; i < 1000U; ++i) {
+      sfc::assert_eq(v.contains(i * 3), true);
+      sfc::assert_eq(v.contains(i * 3 + 1), f.contains(i * 3 + 1));
+    }
+  }
+  (void)fs::remove_file(path);
+
+  // the view borrows the buckets, a power of two of them
+  sfc::assert_eq(CuckooFilter<>::View::from_bytes(f.as_bytes()).unwrap().contains(3U), true);
+  sfc::assert_eq(CuckooFilter<>::View::from_bytes(f.as_bytes()[{0, 24}]).is_err(), true);
+}
+
+}  // namespace sfc::collections::filter::test
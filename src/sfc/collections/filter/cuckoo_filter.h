@@ -0,0 +1,328 @@
+#pragma once
+
+#include "sfc/alloc/buffer.h"
+#include "sfc/fs.h"
+#include "sfc/serde/base64.h"
+
+namespace sfc::collections::filter {
+
+// A cuckoo filter: a 16-bit fingerprint per key, stored in one of two 4-slot buckets.
+// Unlike a Bloom filter it supports removal (of keys that were inserted) and stays accurate up
+// to about 95% occupancy, with a false positive rate near 8 / 2^16.
+// A filter is only meaningful with the hasher it was built with, including after a round trip.
+template <class H = BuildHasher<>>
+class CuckooFilter {
+ public:
+  static constexpr usize kSlots = 4;
+
+  struct Bucket {
+    u16 fps[kSlots];  // zero marks an empty slot
+  };
+
+  class View;
+
+ private:
+  static constexpr usize kMaxKicks = 500;
+
+  // a fingerprint evicted by an insert that ran out of kicks, kept so it still matches
+  struct Victim {
+    u16 fp = 0;
+    usize idx = 0;
+  };
+
+  Buffer<Bucket> _buckets{};
+  usize _len = 0;
+  Victim _victim{};
+  u64 _rng = 0x9E3779B97F4A7C15ULL;
+  [[no_unique_address]] H _hash{};
+
+ public:
+  CuckooFilter() noexcept = default;
+
+  // `num_buckets` is rounded up to a power of two
+  explicit CuckooFilter(usize num_buckets, H hash = {})
+      : _buckets{Buffer<Bucket>::with_capacity_zeroed(num::next_power_of_two(cmp::max(num_buckets, usize{1})))},
+        _hash{mem::move(hash)} {}
+
+  // room for about `items` keys
+  static auto with_capacity(usize items, H hash = {}) -> CuckooFilter {
+    return CuckooFilter{usize(f64(items) / (0.95 * kSlots)) + 1, mem::move(hash)};
+  }
+
+  // the raw buckets, as written by `as_bytes`
+  static auto from_bytes(Slice<const u8> bytes, H hash = {}) -> CuckooFilter {
+    auto res = CuckooFilter{bytes.len() / sizeof(Bucket), mem::move(hash)};
+    res.load_bytes(bytes);
+    return res;
+  }
+
+  auto len() const noexcept -> usize {
+    return _len;
+  }
+
+  auto is_empty() const noexcept -> bool {
+    return _len == 0;
+  }
+
+  auto capacity() const noexcept -> usize {
+    return _buckets.cap() * kSlots;
+  }
+
+  auto load_factor() const noexcept -> f64 {
+    return _buckets.cap() == 0 ? 0.0 : f64(_len) / f64(this->capacity());
+  }
+
+  // the buckets as they lie in memory, for persisting; fingerprints are in native byte order
+  auto as_bytes() const noexcept -> Slice<const u8> {
+    return _buckets.as_bytes();
+  }
+
+  // the buckets as a file, to map back with `View::open`
+  auto write(fs::Path path) const -> io::Result<> {
+    return fs::write(path, this->as_bytes());
+  }
+
+ public:
+  // Returns false when the filter is full. The key is still found afterwards,
+  // but later inserts keep failing until something is removed.
+  auto insert(const auto& key) noexcept -> bool {
+    if (_victim.fp != 0 || _buckets.cap() == 0) {
+      return false;
+    }
+
+    const auto hx = _hash.hash_one(key);
+    auto fp = CuckooFilter::fingerprint(hx);
+    auto idx = this->index_of(hx);
+    _len += 1;
+    if (this->put(idx, fp) || this->put(this->alt_index(idx, fp), fp)) {
+      return true;
+    }
+
+    // kick a random resident to its other bucket until one lands in a free slot
+    idx = (_rng & 1) ? idx : this->alt_index(idx, fp);
+    for (auto n = 0UL; n < kMaxKicks; ++n) {
+      _rng ^= _rng << 13;
+      _rng ^= _rng >> 7;
+      _rng ^= _rng << 17;
+      mem::swap(fp, _buckets[idx].fps[_rng % kSlots]);
+      idx = this->alt_index(idx, fp);
+      if (this->put(idx, fp)) {
+        return true;
+      }
+    }
+    _victim = {fp, idx};
+    return false;
+  }
+
+  // false: `key` is not in the filter; true: it probably is
+  auto contains(const auto& key) const noexcept -> bool {
+    if (_buckets.cap() == 0) {
+      return false;
+    }
+    const auto hx = _hash.hash_one(key);
+    const auto fp = CuckooFilter::fingerprint(hx);
+    const auto i1 = this->index_of(hx);
+    const auto i2 = this->alt_index(i1, fp);
+    if (_victim.fp == fp && (_victim.idx == i1 || _victim.idx == i2)) {
+      return true;
+    }
+    return CuckooFilter::find(_buckets[i1], fp) || CuckooFilter::find(_buckets[i2], fp);
+  }
+
+  // Removes one copy of the key's fingerprint. Only remove keys that were inserted:
+  // removing a false positive drops some other key.
+  auto remove(const auto& key) noexcept -> bool {
+    if (_buckets.cap() == 0) {
+      return false;
+    }
+    const auto hx = _hash.hash_one(key);
+    const auto fp = CuckooFilter::fingerprint(hx);
+    const auto i1 = this->index_of(hx);
+    const auto i2 = this->alt_index(i1, fp);
+
+    if (_victim.fp == fp && (_victim.idx == i1 || _victim.idx == i2)) {
+      _victim = {};
+      _len -= 1;
+      return true;
+    }
+    if (!this->take(i1, fp) && !this->take(i2, fp)) {
+      return false;
+    }
+    _len -= 1;
+
+    // a slot is free now, so the victim may fit again
+    if (_victim.fp != 0) {
+      const auto victim = mem::take(_victim);
+      if (!this->put(victim.idx, victim.fp) && !this->put(this->alt_index(victim.idx, victim.fp), victim.fp)) {
+        _victim = victim;
+      }
+    }
+    return true;
+  }
+
+  void clear() noexcept {
+    ptr::write_bytes(_buckets.ptr(), 0U, _buckets.cap());
+    _len = 0;
+    _victim = {};
+  }
+
+ public:
+  // trait: fmt::Display
+  void fmt(auto& f) const {
+    f.debug_struct("CuckooFilter").field("len", _len).field("capacity", this->capacity());
+  }
+
+  // trait: serde::Serialize
+  void serialize(auto& ser) const {
+    auto imp = ser.serialize_obj();
+    imp.serialize_entry("buckets", _buckets.cap());
+    imp.serialize_entry("victim_fp", _victim.fp);
+    imp.serialize_entry("victim_idx", _victim.idx);
+    imp.serialize_entry("bits", serde::base64::encode(this->as_bytes()));
+  }
+
+  // trait: serde::Deserialize
+  template <class D>
+  static auto deserialize(D& des) {
+    auto visit = [&](auto& obj) -> decltype(obj.template next_val<CuckooFilter>()) {
+      auto buckets = 0UL;
+      auto victim = Victim{};
+      auto bytes = List<u8>{};
+      while (auto key = _TRY(obj.next_key())) {
+        if (*key == "buckets") {
+          buckets = _TRY(obj.template next_val<usize>());
+        } else if (*key == "victim_fp") {
+          victim.fp = _TRY(obj.template next_val<u16>());
+        } else if (*key == "victim_idx") {
+          victim.idx = _TRY(obj.template next_val<usize>());
+        } else if (*key == "bits") {
+          bytes = serde::base64::decode(_TRY(obj.template next_val<Str>()));
+        }
+      }
+      auto res = CuckooFilter{buckets};
+      res.load_bytes(bytes.as_slice());
+      res._victim = victim;
+      res._len += victim.fp != 0;
+      return res;
+    };
+    return des.deserialize_obj(visit);
+  }
+
+ private:
+  void load_bytes(Slice<const u8> bytes) noexcept {
+    const auto cnt = cmp::min(bytes.len(), _buckets.cap() * sizeof(Bucket));
+    ptr::copy_nonoverlapping(bytes.as_ptr(), ptr::cast<u8>(_buckets.ptr()), cnt);
+
+    _len = 0;
+    for (auto i = 0UL; i < _buckets.cap(); ++i) {
+      for (auto fp : _buckets[i].fps) {
+        _len += fp != 0;
+      }
+    }
+  }
+
+  // never zero, which marks an empty slot
+  static auto fingerprint(u64 hx) noexcept -> u16 {
+    return u16((hx >> 32) % 0xFFFFU + 1);
+  }
+
+  auto index_of(u64 hx) const noexcept -> usize {
+    return usize(hx) & (_buckets.cap() - 1);
+  }
+
+  auto alt_index(usize idx, u16 fp) const noexcept -> usize {
+    return CuckooFilter::alt_index(idx, fp, _buckets.cap() - 1);
+  }
+
+  // partial-key cuckoo hashing: the other bucket is derived from the fingerprint alone,
+  // so either bucket leads back to the other
+  static auto alt_index(usize idx, u16 fp, usize mask) noexcept -> usize {
+    return (idx ^ usize(u64{fp} * 0x5bd1e995U)) & mask;
+  }
+
+  static auto find(const Bucket& b, u16 fp) noexcept -> bool {
+    return (b.fps[0] == fp) | (b.fps[1] == fp) | (b.fps[2] == fp) | (b.fps[3] == fp);
+  }
+
+  auto put(usize idx, u16 fp) noexcept -> bool {
+    for (auto& slot : _buckets[idx].fps) {
+      if (slot == 0) {
+        slot = fp;
+        return true;
+      }
+    }
+    return false;
+  }
+
+  auto take(usize idx, u16 fp) noexcept -> bool {
+    for (auto& slot : _buckets[idx].fps) {
+      if (slot == fp) {
+        slot = 0;
+        return true;
+      }
+    }
+    return false;
+  }
+};
+
+// A read-only `CuckooFilter` over buckets it does not copy: a mapped file, or bytes the caller
+// keeps alive. `open` maps the file; only the buckets a lookup touches are read. `as_bytes` does
+// not carry the victim of a failed insert, so neither does a view.
+template <class H>
+class CuckooFilter<H>::View {
+  fs::Mmap _map{};
+  const Bucket* _buckets = nullptr;
+  usize _cnt = 0;
+  [[no_unique_address]] H _hash{};
+
+ public:
+  View() noexcept = default;
+
+  static auto open(fs::Path path, H hash = {}) -> io::Result<View> {
+    auto res = View{};
+    res._map = _TRY(fs::Mmap::open(path));
+    _TRY(res.load(res._map.as_bytes(), mem::move(hash)));
+    return {mem::move(res)};
+  }
+
+  // borrows `bytes`: a power-of-two number of buckets, aligned to a bucket
+  static auto from_bytes(Slice<const u8> bytes, H hash = {}) -> io::Result<View> {
+    auto res = View{};
+    _TRY(res.load(bytes, mem::move(hash)));
+    return {mem::move(res)};
+  }
+
+  auto capacity() const noexcept -> usize {
+    return _cnt * kSlots;
+  }
+
+  auto contains(const auto& key) const noexcept -> bool {
+    if (_cnt == 0) {
+      return false;
+    }
+    const auto hx = _hash.hash_one(key);
+    const auto fp = CuckooFilter::fingerprint(hx);
+    const auto i1 = usize(hx) & (_cnt - 1);
+    const auto i2 = CuckooFilter::alt_index(i1, fp, _cnt - 1);
+    return CuckooFilter::find(_buckets[i1], fp) || CuckooFilter::find(_buckets[i2], fp);
+  }
+
+ private:
+  auto load(Slice<const u8> bytes, H hash) -> io::Result<> {
+    const auto cnt = bytes.len() / sizeof(Bucket);
+    if (reinterpret_cast<usize>(bytes.as_ptr()) % alignof(Bucket) != 0 || cnt * sizeof(Bucket) != bytes.len() ||
+        (cnt & (cnt - 1)) != 0) {
+      return {io::Error::InvalidData};
+    }
+    _buckets = ptr::cast<const Bucket>(bytes.as_ptr());
+    _cnt = cnt;
+    _hash = mem::move(hash);
+    return Ok{};
+  }
+};
+
+}  // namespace sfc::collections::filter
+
+namespace sfc::collections {
+using filter::CuckooFilter;
+}  // namespace sfc::collections
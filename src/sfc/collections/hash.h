@@ -2,6 +2,14 @@
 
 #include "sfc/collections/hash/hash_set.h"
 #include "sfc/collections/hash/hash_map.h"
+#include "sfc/collections/hash/concurrent_map.h"
+#include "sfc/collections/hash/index_map.h"
+#include "sfc/collections/hash/static_map.h"
+#include "sfc/collections/hash/small_map.h"
+#include "sfc/collections/hash/interner.h"
+#include "sfc/collections/hash/cache.h"
+#include "sfc/collections/hash/persistent_map.h"
+#include "sfc/collections/hash/frozen_map.h"
 
 namespace sfc {
 template <class K, class V>
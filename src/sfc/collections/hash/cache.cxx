@@ -0,0 +1,206 @@
+#include "sfc/collections/hash/cache.h"
+#include "sfc/serde/json.h"
+#include "sfc/test/test.h"
+#include "sfc/thread.h"
+
+namespace sfc::collections::hash::test {
+
+SFC_TEST(lru_simple) {
+  auto c = LruCache<u32, u32>{3};
+  sfc::assert_eq(c.capacity(), 3U);
+  sfc::assert_eq(c.put(1, 10), None{});
+  sfc::assert_eq(c.put(2, 20), None{});
+  sfc::assert_eq(c.put(3, 30), None{});
+  sfc::assert_eq(c.len(), 3U);
+
+  // 1 becomes the most recent, so 2 is evicted next
+  sfc::assert_eq(c.get(1U), Option{10U});
+  sfc::assert_eq(c.put(4, 40), None{});
+  sfc::assert_eq(c.len(), 3U);
+  sfc::assert_eq(c.contains_key(2U), false);
+  sfc::assert_eq(c.peek(3U), Option{30U});
+
+  // peek does not refresh 3
+  sfc::assert_eq(c.put(5, 50), None{});
+  sfc::assert_eq(c.contains_key(3U), false);
+
+  sfc::assert_eq(c.put(1, 11), Option{10U});
+  auto keys = List<u32>{};
+  c.iter().for_each([&](const auto& entry) { keys.push(entry.key); });
+  sfc::assert_eq(keys.len(), 3U);
+  sfc::assert_eq(keys[0], 1U);
+  sfc::assert_eq(keys[1], 5U);
+  sfc::assert_eq(keys[2], 4U);
+}
+
+SFC_TEST(lru_remove) {
+  auto c = LruCache<u32, u32>{4};
+  for (auto i = 0U; i < 4U; ++i) {
+    c.put(i, i);
+  }
+  sfc::assert_eq(c.remove(1U), Option{1U});
+  sfc::assert_eq(c.remove(1U), None{});
+  sfc::assert_eq(c.len(), 3U);
+
+  // the slot left by the removal is filled before anything is evicted
+  c.put(9, 9);
+  sfc::assert_eq(c.len(), 4U);
+  sfc::assert_eq(c.stats().evictions, 0U);
+
+  const auto lru = c.pop_lru();
+  sfc::assert_eq(lru.is_some(), true);
+  sfc::assert_eq((*lru)._0, 0U);
+  sfc::assert_eq(c.get(3U), Option{3U});
+  sfc::assert_eq(c.get(2U), Option{2U});
+  sfc::assert_eq(c.get(9U), Option{9U});
+
+  c.clear();
+  sfc::assert_eq(c.is_empty(), true);
+  sfc::assert_eq(c.pop_lru().is_none(), true);
+}
+
+SFC_TEST(lru_churn) {
+  static constexpr auto kCap = 100U;
+  auto c = LruCache<u32, u32>{kCap};
+  for (auto i = 0U; i < 10000U; ++i) {
+    c.put(i, i);
+    if (i % 3 == 0) {
+      c.remove(i - i % 7);
+    }
+    if (i >= kCap / 4) {
+      sfc::assert_eq(c.get(i - kCap / 4).is_some() || (i - kCap / 4) % 7 == 0, true);
+    }
+  }
+  sfc::assert_le(c.len(), kCap);
+
+  auto cnt = 0UL;
+  c.iter().for_each([&](const auto& entry) {
+    sfc::assert_eq(c.peek(entry.key), Option{entry.key});
+    cnt += 1;
+  });
+  sfc::assert_eq(cnt, c.len());
+}
+
+SFC_TEST(cache_no_alloc) {
+  // 3 is a capacity whose index would be sized exactly at its load factor without the spare room
+  const u32 caps[] = {3, 4, 100};
+  for (auto cap : caps) {
+    auto lru = LruCache<u32, u32>{cap};
+    auto clock = ClockCache<u32, u32>{cap};
+    const auto lru_bytes = lru.allocated_bytes();
+    const auto clock_bytes = clock.allocated_bytes();
+    for (auto i = 0U; i < 5000U; ++i) {
+      lru.put(i, i);
+      clock.put(i, i);
+      if (i % 7 == 0) {
+        lru.remove(i - 1);
+        clock.remove(i - 1);
+      }
+    }
+    sfc::assert_eq(lru.allocated_bytes(), lru_bytes);
+    sfc::assert_eq(clock.allocated_bytes(), clock_bytes);
+  }
+}
+
+SFC_TEST(lru_stats) {
+  auto c = LruCache<u32, u32>{2};
+  c.put(1, 1);
+  c.put(2, 2);
+  c.get(1U);
+  c.get(3U);
+  c.put(3, 3);
+
+  const auto s = c.stats();
+  sfc::assert_eq(s.hits, 1U);
+  sfc::assert_eq(s.misses, 1U);
+  sfc::assert_eq(s.evictions, 1U);
+  sfc::assert_eq(s.hit_ratio(), 0.5);
+  sfc::assert_eq(serde::json::to_string(s), R"({"hits":1,"misses":1,"evictions":1})");
+}
+
+SFC_TEST(clock_simple) {
+  auto c = ClockCache<u32, u32>{3};
+  c.put(1, 10);
+  c.put(2, 20);
+  c.put(3, 30);
+
+  // 1 and 3 get a second chance, 2 does not
+  sfc::assert_eq(c.get(1U), Option{10U});
+  sfc::assert_eq(c.get(3U), Option{30U});
+  c.put(4, 40);
+  sfc::assert_eq(c.contains_key(2U), false);
+  sfc::assert_eq(c.len(), 3U);
+
+  // the hand cleared the flag of 1 on its last pass, so 1 goes before 3
+  c.put(5, 50);
+  sfc::assert_eq(c.contains_key(1U), false);
+  sfc::assert_eq(c.contains_key(3U), true);
+
+  sfc::assert_eq(c.remove(3U), Option{30U});
+  sfc::assert_eq(c.len(), 2U);
+  sfc::assert_eq(c.stats().evictions, 2U);
+}
+
+SFC_TEST(clock_churn) {
+  static constexpr auto kCap = 64U;
+  auto c = ClockCache<u32, u32>{kCap};
+  for (auto i = 0U; i < 10000U; ++i) {
+    c.put(i % 200, i);
+    if (i % 5 == 0) {
+      c.remove((i * 7) % 200);
+    }
+    c.get(i % 32);
+  }
+  sfc::assert_le(c.len(), kCap);
+  c.iter().for_each([&](const auto& entry) { sfc::assert_eq(c.peek(entry.key).is_some(), true); });
+}
+
+SFC_TEST(sharded_cache) {
+  auto c = ShardedLruCache<u32, u32>{400, 4};
+  sfc::assert_eq(c.shards(), 4U);
+  sfc::assert_eq(c.capacity(), 400U);
+
+  for (auto i = 0U; i < 50U; ++i) {
+    sfc::assert_eq(c.put(i, i), None{});
+  }
+  sfc::assert_eq(c.get_cloned(7U), Option{7U});
+  sfc::assert_eq(c.get_cloned(70U), None{});
+  sfc::assert_eq(c.remove(7U), Option{7U});
+  sfc::assert_eq(c.contains_key(7U), false);
+
+  const auto s = c.stats();
+  sfc::assert_eq(s.hits, 1U);
+  sfc::assert_eq(s.misses, 1U);
+
+  c.clear();
+  sfc::assert_eq(c.is_empty(), true);
+}
+
+SFC_TEST(sharded_cache_threads) {
+  static constexpr auto kCount = 5000U;
+  auto c = ShardedClockCache<u32, u32>{256};
+
+  auto worker = [&](u32 id) {
+    for (auto i = 0U; i < kCount; ++i) {
+      const auto key = (id * kCount + i) % 512;
+      if (const auto val = c.get_cloned(key)) {
+        sfc::assert_eq(*val, key);
+      } else {
+        c.put(key, key);
+      }
+    }
+  };
+
+  {
+    auto t0 = thread::spawn_joined([&]() { worker(0); });
+    auto t1 = thread::spawn_joined([&]() { worker(1); });
+    auto t2 = thread::spawn_joined([&]() { worker(2); });
+    auto t3 = thread::spawn_joined([&]() { worker(3); });
+  }
+
+  const auto s = c.stats();
+  sfc::assert_eq(s.hits + s.misses, u64{4 * kCount});
+  sfc::assert_le(c.len(), c.capacity());
+}
+
+}  // namespace sfc::collections::hash::test
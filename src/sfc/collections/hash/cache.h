@@ -0,0 +1,604 @@
+#pragma once
+
+#include "sfc/alloc/list.h"
+#include "sfc/collections/hash/pos_tbl.h"
+#include "sfc/sync/mutex.h"
+
+namespace sfc::collections::hash {
+
+// lookup counters of a cache, kept since construction
+struct CacheStats {
+  u64 hits = 0;
+  u64 misses = 0;
+  u64 evictions = 0;
+
+ public:
+  auto hit_ratio() const noexcept -> f64 {
+    const auto total = hits + misses;
+    return total == 0 ? 0.0 : f64(hits) / f64(total);
+  }
+
+  void merge(const CacheStats& other) noexcept {
+    hits += other.hits;
+    misses += other.misses;
+    evictions += other.evictions;
+  }
+
+  // trait: fmt::Display
+  void fmt(auto& f) const {
+    f.debug_struct("CacheStats").field("hits", hits).field("misses", misses).field("evictions", evictions);
+  }
+
+  // trait: serde::Serialize
+  void serialize(auto& ser) const {
+    auto imp = ser.serialize_obj();
+    imp.serialize_entry("hits", hits);
+    imp.serialize_entry("misses", misses);
+    imp.serialize_entry("evictions", evictions);
+  }
+};
+
+namespace detail {
+
+// key -> slab position. A full table is rehashed in place, rather than grown, while no more
+// than half its load is live; an insert after an eviction needs room for `capacity + 1`.
+template <class A>
+auto cache_index(usize capacity, A alloc) -> PosTbl<A> {
+  return PosTbl<A>::with_capacity(2 * (capacity + 1), mem::move(alloc));
+}
+
+}  // namespace detail
+
+// A fixed-capacity map that evicts the least recently used entry once full.
+// Nodes live in one slab and are linked by index, so no operation allocates after construction;
+// get, put and remove are O(1).
+template <class K, class V, class H = BuildHasher<>, class A = alloc::Global>
+class LruCache {
+  static constexpr u32 kNil = num::Int<u32>::MAX;
+
+ public:
+  using Key = K;
+  using Value = V;
+  using Hasher = H;
+
+  struct Entry {
+    K key;
+    V val;
+    u32 _tag;
+    u32 _prev;  // towards the most recently used
+    u32 _next;  // towards the least recently used
+  };
+
+  // from the most to the least recently used
+  struct Iter : iter::Iterator<const Entry&> {
+    const Entry* _nodes;
+    u32 _idx;
+
+   public:
+    auto next() noexcept -> Option<const Entry&> {
+      if (_idx == kNil) {
+        return {};
+      }
+      const auto& node = _nodes[_idx];
+      _idx = node._next;
+      return node;
+    }
+  };
+
+ private:
+  List<Entry, A> _nodes;
+  PosTbl<A> _index;
+  usize _cap;
+  u32 _head = kNil;
+  u32 _tail = kNil;
+  CacheStats _stats{};
+  [[no_unique_address]] H _hash{};
+
+ public:
+  explicit LruCache(usize capacity, H hash = {}, A alloc = {})
+      : _nodes{List<Entry, A>::with_capacity(capacity, alloc)},
+        _index{detail::cache_index(capacity, alloc)},
+        _cap{capacity},
+        _hash{mem::move(hash)} {
+    sfc::assert_(capacity != 0 && capacity < kNil, "LruCache: capacity({}) out of range", capacity);
+  }
+
+  auto len() const noexcept -> usize {
+    return _nodes.len();
+  }
+
+  auto is_empty() const noexcept -> bool {
+    return _nodes.is_empty();
+  }
+
+  auto capacity() const noexcept -> usize {
+    return _cap;
+  }
+
+  auto stats() const noexcept -> CacheStats {
+    return _stats;
+  }
+
+  // the slab and the index, fixed at construction
+  auto allocated_bytes() const noexcept -> usize {
+    return _nodes.capacity() * sizeof(Entry) + _index.allocated_bytes();
+  }
+
+  auto hash_of(const auto& key) const noexcept -> u64 {
+    return _hash.hash_one(key);
+  }
+
+ public:
+  // a hit makes the entry the most recently used one
+  auto get(const auto& key) -> Option<V&> {
+    return this->get_hashed(this->hash_of(key), key);
+  }
+
+  auto get_hashed(u64 hx, const auto& key) -> Option<V&> {
+    const auto idx = _index.find(_nodes.as_ptr(), key, u32(hx));
+    if (!idx) {
+      _stats.misses += 1;
+      return {};
+    }
+    _stats.hits += 1;
+    this->touch(*idx);
+    return _nodes[*idx].val;
+  }
+
+  // looks at an entry without touching its recency or the counters
+  auto peek(const auto& key) const -> Option<const V&> {
+    if (const auto idx = _index.find(_nodes.as_ptr(), key, u32(this->hash_of(key)))) {
+      return _nodes[*idx].val;
+    }
+    return {};
+  }
+
+  auto contains_key(const auto& key) const -> bool {
+    return bool(_index.find(_nodes.as_ptr(), key, u32(this->hash_of(key))));
+  }
+
+  // Returns the previous value of `key`. A new key evicts the least recently used entry when full.
+  auto put(K key, V val) -> Option<V> {
+    const auto hx = this->hash_of(key);
+    return this->put_hashed(hx, mem::move(key), mem::move(val));
+  }
+
+  auto put_hashed(u64 hx, K key, V val) -> Option<V> {
+    const auto tag = u32(hx);
+    if (const auto idx = _index.find(_nodes.as_ptr(), key, tag)) {
+      this->touch(*idx);
+      return mem::replace(_nodes[*idx].val, mem::move(val));
+    }
+
+    auto idx = _tail;
+    if (_nodes.len() < _cap) {
+      idx = u32(_nodes.len());
+      _nodes.push(Entry{mem::move(key), mem::move(val), tag, kNil, kNil});
+    } else {
+      // the evicted node is reused in place
+      this->unlink(idx);
+      auto& node = _nodes[idx];
+      _index.erase(node._tag, idx);
+      node.key = mem::move(key);
+      node.val = mem::move(val);
+      node._tag = tag;
+      _stats.evictions += 1;
+    }
+    _index.insert(tag, idx);
+    this->push_front(idx);
+    return {};
+  }
+
+  auto remove(const auto& key) -> Option<V> {
+    return this->remove_hashed(this->hash_of(key), key);
+  }
+
+  auto remove_hashed(u64 hx, const auto& key) -> Option<V> {
+    const auto idx = _index.remove(_nodes.as_ptr(), key, u32(hx));
+    if (!idx) {
+      return {};
+    }
+    auto node = this->remove_node(*idx);
+    return mem::move(node.val);
+  }
+
+  auto pop_lru() -> Option<Tuple<K, V>> {
+    if (_tail == kNil) {
+      return {};
+    }
+    const auto idx = _tail;
+    _index.erase(_nodes[idx]._tag, idx);
+    auto node = this->remove_node(idx);
+    return Tuple<K, V>{mem::move(node.key), mem::move(node.val)};
+  }
+
+  void clear() {
+    _index.clear();
+    _nodes.clear();
+    _head = kNil;
+    _tail = kNil;
+  }
+
+  auto iter() const noexcept -> Iter {
+    return {{}, _nodes.as_ptr(), _head};
+  }
+
+ public:
+  // trait: fmt::Display
+  void fmt(auto& f) const {
+    auto imp = f.debug_map();
+    this->iter().for_each([&](const Entry& entry) { imp.entry(entry.key, entry.val); });
+  }
+
+ private:
+  void unlink(u32 idx) {
+    const auto& node = _nodes[idx];
+    if (node._prev != kNil) {
+      _nodes[node._prev]._next = node._next;
+    } else {
+      _head = node._next;
+    }
+    if (node._next != kNil) {
+      _nodes[node._next]._prev = node._prev;
+    } else {
+      _tail = node._prev;
+    }
+  }
+
+  void push_front(u32 idx) {
+    auto& node = _nodes[idx];
+    node._prev = kNil;
+    node._next = _head;
+    if (_head != kNil) {
+      _nodes[_head]._prev = idx;
+    } else {
+      _tail = idx;
+    }
+    _head = idx;
+  }
+
+  void touch(u32 idx) {
+    if (idx == _head) {
+      return;
+    }
+    this->unlink(idx);
+    this->push_front(idx);
+  }
+
+  // the index entry is already gone; the last node fills the hole
+  auto remove_node(u32 idx) -> Entry {
+    this->unlink(idx);
+
+    const auto last = u32(_nodes.len() - 1);
+    if (idx != last) {
+      const auto& moved = _nodes[last];
+      _index.relocate(moved._tag, last, idx);
+      if (moved._prev != kNil) {
+        _nodes[moved._prev]._next = idx;
+      } else {
+        _head = idx;
+      }
+      if (moved._next != kNil) {
+        _nodes[moved._next]._prev = idx;
+      } else {
+        _tail = idx;
+      }
+    }
+    return _nodes.swap_remove(idx);
+  }
+};
+
+// A fixed-capacity map with CLOCK (second chance) eviction: a hit only sets a flag,
+// so read-heavy use never relinks nodes. The eviction hand clears flags until it finds
+// an entry that was not used since its last pass.
+template <class K, class V, class H = BuildHasher<>, class A = alloc::Global>
+class ClockCache {
+ public:
+  using Key = K;
+  using Value = V;
+  using Hasher = H;
+
+  struct Entry {
+    K key;
+    V val;
+    u32 _tag;
+    bool _used;
+  };
+
+ private:
+  List<Entry, A> _nodes;
+  PosTbl<A> _index;
+  usize _cap;
+  usize _hand = 0;
+  CacheStats _stats{};
+  [[no_unique_address]] H _hash{};
+
+ public:
+  explicit ClockCache(usize capacity, H hash = {}, A alloc = {})
+      : _nodes{List<Entry, A>::with_capacity(capacity, alloc)},
+        _index{detail::cache_index(capacity, alloc)},
+        _cap{capacity},
+        _hash{mem::move(hash)} {
+    sfc::assert_(capacity != 0 && capacity < num::Int<u32>::MAX, "ClockCache: capacity({}) out of range", capacity);
+  }
+
+  auto len() const noexcept -> usize {
+    return _nodes.len();
+  }
+
+  auto is_empty() const noexcept -> bool {
+    return _nodes.is_empty();
+  }
+
+  auto capacity() const noexcept -> usize {
+    return _cap;
+  }
+
+  auto stats() const noexcept -> CacheStats {
+    return _stats;
+  }
+
+  // the slab and the index, fixed at construction
+  auto allocated_bytes() const noexcept -> usize {
+    return _nodes.capacity() * sizeof(Entry) + _index.allocated_bytes();
+  }
+
+  auto hash_of(const auto& key) const noexcept -> u64 {
+    return _hash.hash_one(key);
+  }
+
+ public:
+  auto get(const auto& key) -> Option<V&> {
+    return this->get_hashed(this->hash_of(key), key);
+  }
+
+  auto get_hashed(u64 hx, const auto& key) -> Option<V&> {
+    const auto idx = _index.find(_nodes.as_ptr(), key, u32(hx));
+    if (!idx) {
+      _stats.misses += 1;
+      return {};
+    }
+    _stats.hits += 1;
+    auto& node = _nodes[*idx];
+    node._used = true;
+    return node.val;
+  }
+
+  auto peek(const auto& key) const -> Option<const V&> {
+    if (const auto idx = _index.find(_nodes.as_ptr(), key, u32(this->hash_of(key)))) {
+      return _nodes[*idx].val;
+    }
+    return {};
+  }
+
+  auto contains_key(const auto& key) const -> bool {
+    return bool(_index.find(_nodes.as_ptr(), key, u32(this->hash_of(key))));
+  }
+
+  auto put(K key, V val) -> Option<V> {
+    const auto hx = this->hash_of(key);
+    return this->put_hashed(hx, mem::move(key), mem::move(val));
+  }
+
+  auto put_hashed(u64 hx, K key, V val) -> Option<V> {
+    const auto tag = u32(hx);
+    if (const auto idx = _index.find(_nodes.as_ptr(), key, tag)) {
+      auto& node = _nodes[*idx];
+      node._used = true;
+      return mem::replace(node.val, mem::move(val));
+    }
+
+    auto idx = 0U;
+    if (_nodes.len() < _cap) {
+      idx = u32(_nodes.len());
+      _nodes.push(Entry{mem::move(key), mem::move(val), tag, false});
+    } else {
+      idx = this->sweep();
+      auto& node = _nodes[idx];
+      _index.erase(node._tag, idx);
+      node.key = mem::move(key);
+      node.val = mem::move(val);
+      node._tag = tag;
+      node._used = false;
+      _stats.evictions += 1;
+    }
+    _index.insert(tag, idx);
+    return {};
+  }
+
+  auto remove(const auto& key) -> Option<V> {
+    return this->remove_hashed(this->hash_of(key), key);
+  }
+
+  auto remove_hashed(u64 hx, const auto& key) -> Option<V> {
+    const auto idx = _index.remove(_nodes.as_ptr(), key, u32(hx));
+    if (!idx) {
+      return {};
+    }
+
+    const auto last = u32(_nodes.len() - 1);
+    if (*idx != last) {
+      _index.relocate(_nodes[last]._tag, last, *idx);
+    }
+    auto node = _nodes.swap_remove(*idx);
+    if (_hand >= _nodes.len()) {
+      _hand = 0;
+    }
+    return mem::move(node.val);
+  }
+
+  void clear() {
+    _index.clear();
+    _nodes.clear();
+    _hand = 0;
+  }
+
+  // in slab order, not by recency
+  auto iter() const noexcept -> slice::Iter<const Entry> {
+    return _nodes.iter();
+  }
+
+ public:
+  // trait: fmt::Display
+  void fmt(auto& f) const {
+    auto imp = f.debug_map();
+    this->iter().for_each([&](const Entry& entry) { imp.entry(entry.key, entry.val); });
+  }
+
+ private:
+  // the cache is full, so every slot holds an entry
+  auto sweep() -> u32 {
+    const auto cnt = _nodes.len();
+    while (_nodes[_hand]._used) {
+      _nodes[_hand]._used = false;
+      _hand = (_hand + 1) % cnt;
+    }
+    const auto res = u32(_hand);
+    _hand = (_hand + 1) % cnt;
+    return res;
+  }
+};
+
+// `LruCache` or `ClockCache` split into independently locked shards; the capacity is divided
+// evenly and each shard evicts on its own. Lookups lock their shard, since a hit updates recency.
+template <class C>
+class ShardedCache {
+  static constexpr usize kDefaultShards = 16;
+  static constexpr usize kCacheLine = 64;
+
+  using K = typename C::Key;
+  using V = typename C::Value;
+  using H = typename C::Hasher;
+
+  // padded so that neighbouring shards never share a cache line
+  struct alignas(kCacheLine) Shard {
+    mutable sync::Mutex _lock{};
+    C _cache;
+  };
+
+  List<Shard> _shards{};
+  usize _mask{0};
+  [[no_unique_address]] H _hash{};
+
+ public:
+  explicit ShardedCache(usize capacity, usize shards = kDefaultShards, H hash = {}) : _hash{mem::move(hash)} {
+    const auto cnt = num::next_power_of_two(cmp::max(shards, usize{1}));
+    const auto shard_cap = cmp::max((capacity + cnt - 1) / cnt, usize{1});
+    _shards.reserve(cnt);
+    for (auto i = 0UL; i < cnt; ++i) {
+      _shards.push(Shard{sync::Mutex{}, C{shard_cap, _hash}});
+    }
+    _mask = cnt - 1;
+  }
+
+  ShardedCache(ShardedCache&&) noexcept = default;
+  ShardedCache& operator=(ShardedCache&&) noexcept = default;
+
+  auto shards() const noexcept -> usize {
+    return _shards.len();
+  }
+
+  auto capacity() const noexcept -> usize {
+    auto res = 0UL;
+    _shards.iter().for_each([&](const Shard& shard) { res += shard._cache.capacity(); });
+    return res;
+  }
+
+  auto len() const -> usize {
+    auto res = 0UL;
+    _shards.iter().for_each([&](const Shard& shard) {
+      auto guard = shard._lock.lock();
+      res += shard._cache.len();
+    });
+    return res;
+  }
+
+  auto is_empty() const -> bool {
+    return this->len() == 0;
+  }
+
+  // counters summed over the shards, each read under its own lock
+  auto stats() const -> CacheStats {
+    auto res = CacheStats{};
+    _shards.iter().for_each([&](const Shard& shard) {
+      auto guard = shard._lock.lock();
+      res.merge(shard._cache.stats());
+    });
+    return res;
+  }
+
+ public:
+  auto contains_key(const auto& key) const -> bool {
+    const auto& shard = this->shard(_hash.hash_one(key));
+    auto guard = shard._lock.lock();
+    return shard._cache.contains_key(key);
+  }
+
+  // the value is copied out under the shard's lock; a reference would outlive it
+  auto get_cloned(const auto& key) -> Option<V> {
+    const auto hx = _hash.hash_one(key);
+    auto& shard = this->shard(hx);
+
+    auto guard = shard._lock.lock();
+    auto p = shard._cache.get_hashed(hx, key);
+    if (!p) {
+      return {};
+    }
+    const auto& val = *p;
+    if constexpr (requires { val.clone(); }) {
+      return val.clone();
+    } else {
+      return val;
+    }
+  }
+
+  auto put(K key, V val) -> Option<V> {
+    const auto hx = _hash.hash_one(key);
+    auto& shard = this->shard(hx);
+
+    auto guard = shard._lock.lock();
+    return shard._cache.put_hashed(hx, mem::move(key), mem::move(val));
+  }
+
+  auto remove(const auto& key) -> Option<V> {
+    const auto hx = _hash.hash_one(key);
+    auto& shard = this->shard(hx);
+
+    auto guard = shard._lock.lock();
+    return shard._cache.remove_hashed(hx, key);
+  }
+
+  void clear() {
+    _shards.iter_mut().for_each([](Shard& shard) {
+      auto guard = shard._lock.lock();
+      shard._cache.clear();
+    });
+  }
+
+ private:
+  // the cache index takes the low half of the hash, so shards are picked from the high half
+  auto shard(u64 hx) const -> const Shard& {
+    return _shards[usize(hx >> 32) & _mask];
+  }
+
+  auto shard(u64 hx) -> Shard& {
+    return _shards[usize(hx >> 32) & _mask];
+  }
+};
+
+template <class K, class V, class H = BuildHasher<>>
+using ShardedLruCache = ShardedCache<LruCache<K, V, H>>;
+
+template <class K, class V, class H = BuildHasher<>>
+using ShardedClockCache = ShardedCache<ClockCache<K, V, H>>;
+
+}  // namespace sfc::collections::hash
+
+namespace sfc::collections {
+using hash::CacheStats;
+using hash::ClockCache;
+using hash::LruCache;
+using hash::ShardedCache;
+using hash::ShardedClockCache;
+using hash::ShardedLruCache;
+}  // namespace sfc::collections
@@ -0,0 +1,85 @@
+#include "sfc/collections/hash/concurrent_map.h"
+#include "sfc/test/test.h"
+#include "sfc/thread.h"
+
+namespace sfc::collections::hash::test {
+
+SFC_TEST(concurrent_map_simple) {
+  auto m = ConcurrentHashMap<u32, u32>{};
+  sfc::assert_eq(m.shards(), 16U);
+  sfc::assert_eq(m.is_empty(), true);
+
+  for (auto i = 0U; i < 100U; ++i) {
+    sfc::assert_eq(m.insert(i, i * 10), None{});
+  }
+  sfc::assert_eq(m.len(), 100U);
+  sfc::assert_eq(m.insert(1, 11), Option{10U});
+  sfc::assert_eq(m.get_cloned(1U), Option{11U});
+  sfc::assert_eq(m.get_cloned(100U), None{});
+  sfc::assert_eq(m.contains_key(99U), true);
+
+  sfc::assert_eq(m.remove(1U), Option{11U});
+  sfc::assert_eq(m.remove(1U), None{});
+  sfc::assert_eq(m.len(), 99U);
+
+  m.clear();
+  sfc::assert_eq(m.len(), 0U);
+}
+
+SFC_TEST(concurrent_map_compute) {
+  auto m = ConcurrentHashMap<u32, u32>::with_shards(3);
+  sfc::assert_eq(m.shards(), 4U);
+
+  const auto incr = [](Option<u32> val) -> Option<u32> { return val.unwrap_or(0) + 1; };
+  sfc::assert_eq(m.compute(7, incr), true);
+  sfc::assert_eq(m.compute(7, incr), true);
+  sfc::assert_eq(m.get_cloned(7U), Option{2U});
+
+  sfc::assert_eq(m.compute(7, [](Option<u32>) -> Option<u32> { return {}; }), false);
+  sfc::assert_eq(m.get_cloned(7U), None{});
+  sfc::assert_eq(m.compute(8, [](Option<u32>) -> Option<u32> { return {}; }), false);
+  sfc::assert_eq(m.len(), 0U);
+}
+
+SFC_TEST(concurrent_map_for_each) {
+  auto m = ConcurrentHashMap<u32, u32>{};
+  for (auto i = 0U; i < 1000U; ++i) {
+    m.insert(i, i);
+  }
+
+  auto cnt = 0U;
+  auto sum = 0U;
+  m.for_each([&](const u32& k, const u32& v) {
+    sfc::assert_eq(k, v);
+    cnt += 1;
+    sum += v;
+  });
+  sfc::assert_eq(cnt, 1000U);
+  sfc::assert_eq(sum, 999U * 1000U / 2);
+}
+
+SFC_TEST(concurrent_map_threads) {
+  static constexpr auto kThreads = 4U;
+  static constexpr auto kCount = 2000U;
+  static constexpr auto kCounter = ~0U;
+  auto m = ConcurrentHashMap<u32, u32>{};
+
+  auto worker = [&](u32 id) {
+    for (auto i = 0U; i < kCount; ++i) {
+      m.insert(id * kCount + i, i);
+      m.compute(kCounter, [](Option<u32> val) -> Option<u32> { return val.unwrap_or(0) + 1; });
+      sfc::assert_eq(m.get_cloned(id * kCount + i), Option{i});
+    }
+  };
+
+  {
+    auto t0 = thread::spawn_joined([&]() { worker(0); });
+    auto t1 = thread::spawn_joined([&]() { worker(1); });
+    auto t2 = thread::spawn_joined([&]() { worker(2); });
+    auto t3 = thread::spawn_joined([&]() { worker(3); });
+  }
+  sfc::assert_eq(m.len(), kThreads * kCount + 1);
+  sfc::assert_eq(m.get_cloned(kCounter), Option{kThreads * kCount});
+}
+
+}  // namespace sfc::collections::hash::test
@@ -0,0 +1,176 @@
+#pragma once
+
+#include "sfc/alloc/list.h"
+#include "sfc/collections/hash/hash_tbl.h"
+#include "sfc/sync/rwlock.h"
+
+namespace sfc::collections::hash {
+
+// A map split into independently locked shards: writers lock one shard, readers share it.
+template <class K, class V, class H = BuildHasher<>>
+class ConcurrentHashMap {
+  static constexpr usize kDefaultShards = 16;
+  static constexpr usize kCacheLine = 64;
+
+  struct Item {
+    K key;
+    V val;
+  };
+  using Tbl = HashTbl<Item, H>;
+
+  // padded so that neighbouring shards never share a cache line
+  struct alignas(kCacheLine) Shard {
+    mutable sync::RwLock _lock{};
+    Tbl _tbl{};
+  };
+
+  List<Shard> _shards{};
+  usize _mask{0};
+  [[no_unique_address]] H _hash{};
+
+ public:
+  ConcurrentHashMap() : ConcurrentHashMap{kDefaultShards} {}
+
+  explicit ConcurrentHashMap(usize shards, H hash = {}) : _hash{mem::move(hash)} {
+    const auto cnt = num::next_power_of_two(cmp::max(shards, usize{1}));
+    _shards.reserve(cnt);
+    for (auto i = 0UL; i < cnt; ++i) {
+      _shards.push(Shard{sync::RwLock{}, Tbl{_hash}});
+    }
+    _mask = cnt - 1;
+  }
+
+  static auto with_shards(usize shards) -> ConcurrentHashMap {
+    return ConcurrentHashMap{shards};
+  }
+
+  static auto with_hasher(H hash, usize shards = kDefaultShards) -> ConcurrentHashMap {
+    return ConcurrentHashMap{shards, mem::move(hash)};
+  }
+
+  ConcurrentHashMap(ConcurrentHashMap&&) noexcept = default;
+  ConcurrentHashMap& operator=(ConcurrentHashMap&&) noexcept = default;
+
+  auto shards() const noexcept -> usize {
+    return _shards.len();
+  }
+
+  // a sum of per-shard lengths, each read under its own lock
+  auto len() const -> usize {
+    auto res = 0UL;
+    _shards.iter().for_each([&](const Shard& shard) {
+      auto guard = shard._lock.read();
+      res += shard._tbl.len();
+    });
+    return res;
+  }
+
+  auto is_empty() const -> bool {
+    return this->len() == 0;
+  }
+
+ public:
+  auto contains_key(const auto& key) const -> bool {
+    const auto hx = _hash.hash_one(key);
+    const auto& shard = this->shard(hx);
+
+    auto guard = shard._lock.read();
+    return shard._tbl.search_hashed(hx, key) != nullptr;
+  }
+
+  // the value is copied out under the shard's read lock; a reference would outlive it
+  auto get_cloned(const auto& key) const -> Option<V> {
+    const auto hx = _hash.hash_one(key);
+    const auto& shard = this->shard(hx);
+
+    auto guard = shard._lock.read();
+    const auto p = shard._tbl.search_hashed(hx, key);
+    if (p == nullptr) {
+      return {};
+    }
+    if constexpr (requires { p->val.clone(); }) {
+      return p->val.clone();
+    } else {
+      return p->val;
+    }
+  }
+
+  auto insert(K key, V val) -> Option<V> {
+    const auto hx = _hash.hash_one(key);
+    auto& shard = this->shard(hx);
+
+    auto guard = shard._lock.write();
+    const auto slot = shard._tbl.search_slot(hx, key);
+    if (slot.ptr) {
+      return mem::replace(slot.ptr->val, mem::move(val));
+    }
+    shard._tbl.insert_slot(slot, {mem::move(key), mem::move(val)});
+    return {};
+  }
+
+  auto remove(const auto& key) -> Option<V> {
+    const auto hx = _hash.hash_one(key);
+    auto& shard = this->shard(hx);
+
+    auto guard = shard._lock.write();
+    return shard._tbl.remove_hashed(hx, key).map([](auto item) { return mem::move(item.val); });
+  }
+
+  // atomically replace the value for `key`: `f` takes the current value (or None) and
+  // returns the new one, or None to remove the entry. Returns whether the key is now present.
+  auto compute(K key, auto&& f) -> bool {
+    const auto hx = _hash.hash_one(key);
+    auto& shard = this->shard(hx);
+
+    auto guard = shard._lock.write();
+    const auto slot = shard._tbl.search_slot(hx, key);
+    if (slot.ptr == nullptr) {
+      auto val = f(Option<V>{});
+      if (!val) {
+        return false;
+      }
+      shard._tbl.insert_slot(slot, {mem::move(key), mem::move(*val)});
+      return true;
+    }
+
+    auto val = f(Option<V>{mem::move(slot.ptr->val)});
+    if (!val) {
+      shard._tbl.erase_slot(slot.idx);
+      return false;
+    }
+    slot.ptr->val = mem::move(*val);
+    return true;
+  }
+
+  void clear() {
+    _shards.iter_mut().for_each([](Shard& shard) {
+      auto guard = shard._lock.write();
+      shard._tbl.clear();
+    });
+  }
+
+  // visits every entry; each shard is read-locked for the whole of its visit, so `f` sees a
+  // consistent snapshot of one shard at a time (not of the whole map)
+  void for_each(auto&& f) const {
+    _shards.iter().for_each([&](const Shard& shard) {
+      auto guard = shard._lock.read();
+      shard._tbl.iter().for_each([&](const Item& item) { f(item.key, item.val); });
+    });
+  }
+
+ private:
+  // h1 takes the low bits and h2 the top 7, so shards are picked from the middle
+  auto shard(u64 hx) const -> const Shard& {
+    return _shards[usize(hx >> 32) & _mask];
+  }
+
+  auto shard(u64 hx) -> Shard& {
+    return _shards[usize(hx >> 32) & _mask];
+  }
+};
+
+}  // namespace sfc::collections::hash
+
+namespace sfc::collections {
+using hash::ConcurrentHashMap;
+}
@@ -0,0 +1,73 @@
+#include "sfc/collections/hash/frozen_map.h"
+#include "sfc/env.h"
+#include "sfc/test/test.h"
+
+namespace sfc::collections::hash::test {
+
+SFC_TEST(frozen_bytes) {
+  auto m = HashMap<u64, u32>{};
+  for (auto i = 0U; i < 1000U; ++i) {
+    m.insert(u64(i) * 7919, i);
+  }
+
+  const auto f = FrozenMap<u64, u32>::from_bytes(FrozenMap<u64, u32>::image_of(m)).unwrap();
+  sfc::assert_eq(f.len(), 1000U);
+  sfc::assert_ge(f.capacity(), 1000U * 4 / 3);
+  for (auto i = 0U; i < 1000U; ++i) {
+    sfc::assert_eq(f.get(u64(i) * 7919), Option{i});
+    sfc::assert_eq(f.contains_key(u64(i) * 7919 + 1), false);
+  }
+}
+
+SFC_TEST(frozen_empty) {
+  const auto m = HashMap<u32, u32>{};
+  const auto f = FrozenMap<u32, u32>::from_bytes(FrozenMap<u32, u32>::image_of(m)).unwrap();
+  sfc::assert_eq(f.is_empty(), true);
+  sfc::assert_eq(f.get(0U), None{});
+}
+
+SFC_TEST(frozen_invalid) {
+  auto m = HashMap<u32, u32>{};
+  m.insert(1, 2);
+
+  // an image for another item layout
+  const auto other = FrozenMap<u32, u64>::from_bytes(FrozenMap<u32, u32>::image_of(m));
+  sfc::assert_eq(other.is_err(), true);
+
+  auto buf = FrozenMap<u32, u32>::image_of(m);
+  (void)buf.pop();
+  sfc::assert_eq(FrozenMap<u32, u32>::from_bytes(mem::move(buf)).is_err(), true);
+  sfc::assert_eq(FrozenMap<u32, u32>::from_bytes(List<u8>{}).is_err(), true);
+
+  // every ctrl byte full: `get` would find no empty byte to stop at
+  auto full = FrozenMap<u32, u32>::image_of(m);
+  const auto cap = HashTblStorage<>::capacity_for(2);
+  const auto ctrl_size = HashTblStorage<>::ctrl_size(cap);
+  ptr::write_bytes(full.as_mut_ptr() + full.len() - cap * 2 * sizeof(u32) - ctrl_size, 0x01U, ctrl_size);
+  sfc::assert_eq(FrozenMap<u32, u32>::from_bytes(mem::move(full)).is_err(), true);
+}
+
+SFC_TEST(frozen_file) {
+  const auto path_buf = env::temp_dir().join(fs::Path{"test_frozen_map.bin"});
+  const auto path = path_buf.as_path();
+
+  struct Point {
+    i32 x;
+    i32 y;
+  };
+  auto m = HashMap<u32, Point>{};
+  for (auto i = 0U; i < 500U; ++i) {
+    m.insert(i, Point{i32(i), -i32(i)});
+  }
+  sfc::assert_eq(FrozenMap<u32, Point>::write(path, m).is_ok(), true);
+
+  {
+    const auto f = FrozenMap<u32, Point>::open(path).unwrap();
+    sfc::assert_eq(f.len(), 500U);
+    sfc::assert_eq(f.get(123U)->y, -123);
+    sfc::assert_eq(f.get(500U).is_none(), true);
+  }
+  (void)fs::remove_file(path);
+}
+
+}  // namespace sfc::collections::hash::test
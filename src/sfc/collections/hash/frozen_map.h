@@ -0,0 +1,194 @@
+#pragma once
+
+#include "sfc/collections/hash/hash_map.h"
+#include "sfc/fs.h"
+
+namespace sfc::collections::hash {
+
+// A read-only `HashMap` kept as one flat image: a header, then the ctrl bytes and slots exactly as
+// `HashTblStorage` lays them out, so `get` probes the image in place. `write` freezes a map into a
+// file and `open` maps it back read-only: startup costs a scan of the ctrl bytes and the page
+// faults of the slots looked up, not a rebuild. Keys and values must be trivially copyable. An
+// image is tied to the hasher, the group width and the item layout of the build that wrote it;
+// `open` rejects any other.
+template <class K, class V, class H = BuildHasher<>>
+class FrozenMap {
+  static_assert(__is_trivially_copyable(K) && __is_trivially_copyable(V));
+
+  static constexpr u64 kMagic = 0x50414d4e5a4f5246ULL;  // "FROZNMAP"
+  static constexpr u32 kVersion = 1;
+  static constexpr usize kAlign = 16;
+  static constexpr u64 kProbeKey = 0x9e3779b97f4a7c15ULL;
+
+  struct Item {
+    K key;
+    V val;
+  };
+  static_assert(alignof(Item) <= kAlign);
+
+  struct Header {
+    u64 magic;
+    u32 version;
+    u32 group_width;
+    u64 item_size;
+    u64 cap;
+    u64 len;
+    u64 probe;  // the hash of `kProbeKey`, so a different hasher is caught on open
+    u64 reserved[2];
+  };
+  static_assert(sizeof(Header) % kAlign == 0);
+
+  // the bytes behind `_ctrl`: a mapping, or a buffer
+  fs::Mmap _map{};
+  List<u8> _buf{};
+
+  const u8* _ctrl = nullptr;
+  const Item* _data = nullptr;
+  usize _cap = 0;
+  usize _len = 0;
+  [[no_unique_address]] H _hash{};
+
+ public:
+  FrozenMap() noexcept = default;
+
+  // the image of `map`, sized for a load factor of 3/4
+  template <class A>
+  static auto image_of(const HashMap<K, V, H, A>& map) -> List<u8> {
+    const auto cap = HashTblStorage<>::capacity_for(map.len() + map.len() / 3 + 1);
+    const auto ctrl_size = HashTblStorage<>::ctrl_size(cap);
+
+    auto res = List<u8>{};
+    res.resize(sizeof(Header) + ctrl_size + cap * sizeof(Item), 0);
+
+    const auto hdr = Header{
+        .magic = kMagic,
+        .version = kVersion,
+        .group_width = u32(Group::WIDTH),
+        .item_size = sizeof(Item),
+        .cap = cap,
+        .len = map.len(),
+        .probe = map.hash_key(kProbeKey),
+        .reserved = {},
+    };
+    ptr::copy_nonoverlapping(ptr::cast<const u8>(&hdr), res.as_mut_ptr(), sizeof(Header));
+
+    const auto ctrl = res.as_mut_ptr() + sizeof(Header);
+    const auto data = ptr::cast<Item>(ctrl + ctrl_size);
+    ptr::write_bytes(ctrl, CTRL_NUL, ctrl_size);
+    map.for_each([&](const K& key, const V& val) {
+      const auto hx = map.hash_key(key);
+      auto bucket = Bucket<Item>{ctrl, data, cap - 1, hx & (cap - 1)};
+      bucket.insert_at(bucket.search_nul(), u8((hx >> 57) & 0x7F), Item{key, val});
+    });
+    return res;
+  }
+
+  template <class A>
+  static auto write(fs::Path path, const HashMap<K, V, H, A>& map) -> io::Result<> {
+    const auto buf = FrozenMap::image_of(map);
+    return fs::write(path, buf.as_slice());
+  }
+
+  // maps the file read-only; `open` checks the ctrl bytes, the slots are not read until a
+  // lookup touches them
+  static auto open(fs::Path path) -> io::Result<FrozenMap> {
+    auto res = FrozenMap{};
+    res._map = _TRY(fs::Mmap::open(path));
+    _TRY(res.load(res._map.as_bytes()));
+    return {mem::move(res)};
+  }
+
+  // an image already in memory, e.g. from `image_of`
+  static auto from_bytes(List<u8> buf) -> io::Result<FrozenMap> {
+    auto res = FrozenMap{};
+    res._buf = mem::move(buf);
+    _TRY(res.load(res._buf.as_slice()));
+    return {mem::move(res)};
+  }
+
+  auto len() const noexcept -> usize {
+    return _len;
+  }
+
+  auto is_empty() const noexcept -> bool {
+    return _len == 0;
+  }
+
+  auto capacity() const noexcept -> usize {
+    return _cap;
+  }
+
+ public:
+  auto contains_key(const auto& key) const noexcept -> bool {
+    return this->search(key) != nullptr;
+  }
+
+  auto get(const auto& key) const noexcept -> Option<const V&> {
+    if (const auto p = this->search(key)) {
+      return p->val;
+    }
+    return {};
+  }
+
+ private:
+  auto search(const auto& key) const noexcept -> const Item* {
+    if (_cap == 0) {
+      return nullptr;
+    }
+    const auto hx = _hash.hash_one(key);
+    // probing only reads through the bucket, so the image may stay read-only
+    const auto bucket = Bucket<Item>{ptr::cast_mut(_ctrl), ptr::cast_mut(_data), _cap - 1, hx & (_cap - 1)};
+    return bucket.search_key(u8((hx >> 57) & 0x7F), key).ptr;
+  }
+
+  auto load(Slice<const u8> bytes) -> io::Result<> {
+    if (bytes.len() < sizeof(Header) || reinterpret_cast<usize>(bytes.as_ptr()) % kAlign != 0) {
+      return {io::Error::InvalidData};
+    }
+
+    auto hdr = Header{};
+    ptr::copy_nonoverlapping(bytes.as_ptr(), ptr::cast<u8>(&hdr), sizeof(Header));
+    if (hdr.magic != kMagic || hdr.version != kVersion || hdr.group_width != Group::WIDTH ||
+        hdr.item_size != sizeof(Item) || hdr.probe != _hash.hash_one(kProbeKey)) {
+      return {io::Error::InvalidData};
+    }
+
+    const auto cap = usize(hdr.cap);
+    if (cap == 0 || (cap & (cap - 1)) != 0 || cap > bytes.len() || hdr.len >= cap) {
+      return {io::Error::InvalidData};
+    }
+    const auto ctrl_size = HashTblStorage<>::ctrl_size(cap);
+    if (bytes.len() != sizeof(Header) + ctrl_size + cap * sizeof(Item)) {
+      return {io::Error::InvalidData};
+    }
+
+    // `get` stops at an empty byte: the full bytes must match `len`, which leaves at least one
+    // empty byte, and the mirrored group must match the start
+    const auto ctrl = bytes.as_ptr() + sizeof(Header);
+    auto full = 0UL;
+    for (auto i = 0UL; i < cap; ++i) {
+      if ((ctrl[i] & 0x80U) != 0 && ctrl[i] != CTRL_NUL) {
+        return {io::Error::InvalidData};
+      }
+      if (ctrl[((i - Group::WIDTH) & (cap - 1)) + Group::WIDTH] != ctrl[i]) {
+        return {io::Error::InvalidData};
+      }
+      full += ctrl[i] != CTRL_NUL;
+    }
+    if (full != hdr.len) {
+      return {io::Error::InvalidData};
+    }
+
+    _ctrl = ctrl;
+    _data = ptr::cast<const Item>(_ctrl + ctrl_size);
+    _cap = cap;
+    _len = usize(hdr.len);
+    return Ok{};
+  }
+};
+
+}  // namespace sfc::collections::hash
+
+namespace sfc::collections {
+using hash::FrozenMap;
+}  // namespace sfc::collections
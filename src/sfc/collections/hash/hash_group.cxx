@@ -0,0 +1,53 @@
+#include "sfc/collections/hash/hash_group.h"
+#include "sfc/test/test.h"
+
+namespace sfc::collections::hash::test {
+
+SFC_TEST(group_match) {
+  u8 ctrl[Group::WIDTH];
+  for (auto i = 0U; i < Group::WIDTH; ++i) {
+    ctrl[i] = u8(i % 3 == 0 ? CTRL_NUL : i % 3 == 1 ? CTRL_DEL : 0x2A);
+  }
+
+  const auto grp = Group::load(ctrl);
+  auto tags = grp.match_byte(0x2A);
+  auto nuls = grp.match_empty();
+  auto full = grp.match_full();
+  for (auto i = 0U; i < Group::WIDTH; ++i) {
+    if (i % 3 == 0) {
+      sfc::assert_eq(nuls.next(), Option{usize{i}});
+    } else if (i % 3 == 2) {
+      sfc::assert_eq(tags.next(), Option{usize{i}});
+      sfc::assert_eq(full.next(), Option{usize{i}});
+    }
+  }
+  sfc::assert_eq(tags.next(), None{});
+  sfc::assert_eq(nuls.next(), None{});
+  sfc::assert_eq(full.next(), None{});
+}
+
+SFC_TEST(group_truncate) {
+  u8 ctrl[Group::WIDTH];
+  ptr::write_bytes(ctrl, 0x11, Group::WIDTH);
+
+  auto m = Group::load(ctrl).match_full().truncate(3);
+  sfc::assert_eq(m.next(), Option{usize{0}});
+  sfc::assert_eq(m.next(), Option{usize{1}});
+  sfc::assert_eq(m.next(), Option{usize{2}});
+  sfc::assert_eq(m.next(), None{});
+}
+
+SFC_TEST(group_zeros) {
+  u8 ctrl[Group::WIDTH];
+  ptr::write_bytes(ctrl, 0x11, Group::WIDTH);
+  sfc::assert_eq(Group::load(ctrl).match_empty().leading_zeros(), Group::WIDTH);
+  sfc::assert_eq(Group::load(ctrl).match_empty().trailing_zeros(), Group::WIDTH);
+
+  ctrl[2] = CTRL_NUL;
+  ctrl[Group::WIDTH - 3] = CTRL_NUL;
+  const auto m = Group::load(ctrl).match_empty();
+  sfc::assert_eq(m.trailing_zeros(), 2U);
+  sfc::assert_eq(m.leading_zeros(), 2U);
+}
+
+}  // namespace sfc::collections::hash::test
@@ -0,0 +1,130 @@
+#pragma once
+
+#include "sfc/core.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64)
+#include <emmintrin.h>
+#define SFC_HASH_SSE2 1
+#endif
+
+namespace sfc::collections::hash {
+
+static constexpr u8 CTRL_NUL = 0x80U;
+static constexpr u8 CTRL_DEL = 0xFFU;
+
+// control byte: full slots hold the 7-bit h2 tag (high bit clear)
+inline auto is_full(u8 ctrl) noexcept -> bool {
+  return ctrl < CTRL_NUL;
+}
+
+// a set of slot offsets inside one control group
+struct BitMask {
+#ifdef SFC_HASH_SSE2
+  static constexpr u32 kShift = 0;  // one bit per ctrl byte
+  static constexpr u32 kBits = 16;
+#else
+  static constexpr u32 kShift = 3;  // the high bit of each ctrl byte
+  static constexpr u32 kBits = 64;
+#endif
+  u64 _bits = 0;
+
+ public:
+  explicit operator bool() const noexcept {
+    return _bits != 0;
+  }
+
+  auto lowest() const noexcept -> usize {
+    return usize(__builtin_ctzll(_bits)) >> kShift;
+  }
+
+  // number of unset offsets below the lowest set one
+  auto trailing_zeros() const noexcept -> usize {
+    if (_bits == 0) return kBits >> kShift;
+    return usize(__builtin_ctzll(_bits)) >> kShift;
+  }
+
+  // number of unset offsets above the highest set one
+  auto leading_zeros() const noexcept -> usize {
+    if (_bits == 0) return kBits >> kShift;
+    return usize(u32(__builtin_clzll(_bits)) - (64 - kBits)) >> kShift;
+  }
+
+  // keep only the offsets in [0, n)
+  auto truncate(usize n) const noexcept -> BitMask {
+    const auto nbits = n << kShift;
+    if (nbits >= 64) return *this;
+    return BitMask{_bits & ((u64{1} << nbits) - 1)};
+  }
+
+  auto next() noexcept -> Option<usize> {
+    if (_bits == 0) return {};
+    const auto idx = this->lowest();
+    _bits &= _bits - 1;
+    return idx;
+  }
+};
+
+// a window of WIDTH control bytes, matched all at once
+struct Group {
+#ifdef SFC_HASH_SSE2
+  static constexpr usize WIDTH = 16;
+  __m128i _val;
+
+ public:
+  static auto load(const u8* ctrl) noexcept -> Group {
+    return Group{_mm_loadu_si128(reinterpret_cast<const __m128i*>(ctrl))};
+  }
+
+  auto match_byte(u8 tag) const noexcept -> BitMask {
+    const auto cmp = _mm_cmpeq_epi8(_val, _mm_set1_epi8(char(tag)));
+    return BitMask{u32(_mm_movemask_epi8(cmp))};
+  }
+
+  auto match_empty() const noexcept -> BitMask {
+    return this->match_byte(CTRL_NUL);
+  }
+
+  auto match_empty_or_deleted() const noexcept -> BitMask {
+    return BitMask{u32(_mm_movemask_epi8(_val))};
+  }
+
+  auto match_full() const noexcept -> BitMask {
+    return BitMask{~u32(_mm_movemask_epi8(_val)) & 0xFFFFU};
+  }
+#else
+  static constexpr usize WIDTH = 8;
+  static constexpr u64 kLsb = 0x0101010101010101ULL;
+  static constexpr u64 kMsb = 0x8080808080808080ULL;
+  u64 _val;
+
+ public:
+  static auto load(const u8* ctrl) noexcept -> Group {
+    auto val = u64{0};
+    __builtin_memcpy(&val, ctrl, sizeof(val));
+#if __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    val = __builtin_bswap64(val);
+#endif
+    return Group{val};
+  }
+
+  // may report a false positive right after a true one, callers always compare the key
+  auto match_byte(u8 tag) const noexcept -> BitMask {
+    const auto x = _val ^ (kLsb * tag);
+    return BitMask{(x - kLsb) & ~x & kMsb};
+  }
+
+  auto match_empty() const noexcept -> BitMask {
+    return BitMask{_val & ~(_val << 1) & kMsb};
+  }
+
+  auto match_empty_or_deleted() const noexcept -> BitMask {
+    return BitMask{_val & kMsb};
+  }
+
+  auto match_full() const noexcept -> BitMask {
+    return BitMask{~_val & kMsb};
+  }
+#endif
+};
+
+}  // namespace sfc::collections::hash
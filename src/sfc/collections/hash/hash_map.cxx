@@ -1,4 +1,6 @@
 #include "sfc/collections/hash/hash_map.h"
+#include "sfc/alloc/mem_pool.h"
+#include "sfc/serde/json.h"
 #include "sfc/test/test.h"
 
 namespace sfc::collections::hash::test {
@@ -83,4 +85,243 @@ SFC_TEST(map_remove) {
   sfc::assert_eq(t.len(), 0U);
 }
 
+SFC_TEST(map_churn) {
+  auto t = HashMap<u32, u32>{};
+  for (auto i = 0U; i < 10000U; ++i) {
+    t.insert(i, i);
+  }
+
+  for (auto i = 0U; i < 10000U; i += 2) {
+    sfc::assert_eq(t.remove(i), Option{i});
+  }
+  sfc::assert_eq(t.len(), 5000U);
+
+  for (auto i = 1U; i < 10000U; i += 2) {
+    sfc::assert_eq(t.get(i - 1), None{});
+    sfc::assert_eq(t.get(i), Option{i});
+  }
+
+  for (auto i = 0U; i < 10000U; i += 2) {
+    sfc::assert_eq(t.try_insert(i, i * 10), None{});
+  }
+  sfc::assert_eq(t.len(), 10000U);
+  sfc::assert_eq(t.get(9998U), Option{99980U});
+}
+
+SFC_TEST(map_steady_churn) {
+  auto t = HashMap<u32, u32>{};
+  for (auto i = 0U; i < 1000U; ++i) {
+    t.insert(i, i);
+  }
+  const auto cap = t.capacity();
+
+  // a sliding window of live keys must not keep growing the table
+  for (auto i = 1000U; i < 200000U; ++i) {
+    t.insert(i, i);
+    sfc::assert_eq(t.remove(i - 1000U), Option{i - 1000U});
+  }
+  sfc::assert_eq(t.len(), 1000U);
+  sfc::assert_le(t.capacity(), cap * 2);
+  sfc::assert_eq(t.get(199999U), Option{199999U});
+}
+
+SFC_TEST(map_shrink_to_fit) {
+  auto t = HashMap<u32, u32>{};
+  for (auto i = 0U; i < 10000U; ++i) {
+    t.insert(i, i);
+  }
+  for (auto i = 100U; i < 10000U; ++i) {
+    t.remove(i);
+  }
+
+  t.shrink_to_fit();
+  sfc::assert_le(t.capacity(), 256U);
+  for (auto i = 0U; i < 100U; ++i) {
+    sfc::assert_eq(t.get(i), Option{i});
+  }
+
+  t.clear();
+  t.shrink_to_fit();
+  sfc::assert_eq(t.capacity(), 0U);
+  t.insert(1, 1);
+  sfc::assert_eq(t.get(1U), Option{1U});
+}
+
+SFC_TEST(map_incremental_resize) {
+  auto t = HashMap<u32, u32>{};
+  t.set_incremental_resize(true);
+
+  for (auto i = 0U; i < 20000U; ++i) {
+    sfc::assert_eq(t.insert(i, i), None{});
+    if (i % 3 == 0) {
+      sfc::assert_eq(t.remove(i / 2), Option{i / 2});
+    }
+    if (i % 7 == 0) {
+      sfc::assert_eq(t.insert(i, i + 1), Option{i});
+    }
+  }
+
+  auto cnt = 0U;
+  for (auto i = 0U; i < 20000U; ++i) {
+    const auto removed = i < 10000U && (i * 2) % 3 == 0;
+    const auto val = i % 7 == 0 ? i + 1 : i;
+    if (removed) {
+      sfc::assert_eq(t.get(i), None{});
+    } else {
+      sfc::assert_eq(t.get(i), Option{val});
+      cnt += 1;
+    }
+  }
+  sfc::assert_eq(t.len(), usize{cnt});
+
+  t.set_incremental_resize(false);
+  sfc::assert_eq(t.get(19999U), Option{19999U});
+  sfc::assert_eq(t.len(), usize{cnt});
+}
+
+SFC_TEST(map_identity_hash) {
+  auto t = HashMap<u64, u32, BuildHasher<sfc::hash::IdentityHasher>>{};
+  for (auto i = 0U; i < 100U; ++i) {
+    t.insert(u64{i} * 0x9E3779B97F4A7C15ULL, i);
+  }
+
+  for (auto i = 0U; i < 100U; ++i) {
+    sfc::assert_eq(t.get(u64{i} * 0x9E3779B97F4A7C15ULL), Option{i});
+  }
+  sfc::assert_eq(t.get(1UL), None{});
+}
+
+SFC_TEST(map_stats) {
+  auto t = HashMap<u32, u32>{};
+  sfc::assert_eq(t.stats().bytes, 0U);
+
+  for (auto i = 0U; i < 1000U; ++i) {
+    t.insert(i, i);
+  }
+  for (auto i = 0U; i < 1000U; i += 2) {
+    t.remove(i);
+  }
+
+  const auto s = t.stats();
+  sfc::assert_eq(s.len, 500U);
+  sfc::assert_eq(s.capacity, t.capacity());
+  sfc::assert_le(s.tombstones, 500U);
+  sfc::assert_ge(s.rehashes, 1U);
+  sfc::assert_ge(s.bytes, s.capacity * 8U);
+  sfc::assert_eq(s.load_factor, f64(s.len) / f64(s.capacity));
+
+  auto hist_len = 0UL;
+  for (auto n : s.probe_hist) {
+    hist_len += n;
+  }
+  sfc::assert_eq(hist_len, usize{500});
+  sfc::assert_ge(s.max_probe, 1U);
+
+  const auto txt = string::format("{}", s);
+  sfc::assert_eq(txt.starts_with("TblStats {"), true);
+  const auto js = serde::json::to_string(s);
+  sfc::assert_eq(js.contains("\"len\":500"), true);
+  sfc::assert_eq(js.contains("\"probe_hist\":["), true);
+}
+
+SFC_TEST(map_stats_collisions) {
+  // every key lands on slot 0, so the probe lengths grow with the table
+  auto t = HashMap<u64, u32, BuildHasher<sfc::hash::IdentityHasher>>{};
+  for (auto i = 0U; i < 64U; ++i) {
+    t.insert(u64{i} << 32, i);
+  }
+
+  const auto s = t.stats();
+  // the first group holds `Group::WIDTH` of them: 16 with SSE2, 8 with the SWAR fallback
+  sfc::assert_eq(s.probe_hist[0], Group::WIDTH);
+  sfc::assert_ge(s.max_probe, 4U);
+  sfc::assert_gt(s.avg_probe, 1.0);
+}
+
+SFC_TEST(map_entry) {
+  auto t = HashMap<u32, u32>{};
+  for (auto i = 0U; i < 100U; ++i) {
+    t.entry(i % 10).and_modify([](u32& v) { v += 1; }).or_insert(1);
+  }
+  sfc::assert_eq(t.len(), 10U);
+  sfc::assert_eq(t.get(3U), Option{10U});
+
+  auto e = t.entry(3);
+  sfc::assert_eq(e.is_occupied(), true);
+  sfc::assert_eq(e.occupied().remove(), 10U);
+  sfc::assert_eq(t.get(3U), None{});
+
+  auto v = t.entry(42);
+  sfc::assert_eq(v.is_vacant(), true);
+  sfc::assert_eq(v.vacant().insert(7), 7U);
+  sfc::assert_eq(t.entry(42).or_insert_with([] { return 0U; }), 7U);
+  sfc::assert_eq(t.entry(43).or_default(), 0U);
+  sfc::assert_eq(t.len(), 11U);
+}
+
+SFC_TEST(map_entry_full) {
+  // at the load factor, only a new key makes the table grow
+  auto t = HashMap<u32, u32>{};
+  for (auto i = 0U; i < 6U; ++i) {
+    t.insert(i, i);
+  }
+  const auto cap = t.capacity();
+  sfc::assert_eq(t.insert(3, 30), Option{3U});
+  t.entry(5).and_modify([](u32& v) { v += 1; }).or_insert(0);
+  sfc::assert_eq(t.capacity(), cap);
+  sfc::assert_eq(t.get(5U), Option{6U});
+
+  t.insert(6, 6);
+  sfc::assert_gt(t.capacity(), cap);
+  sfc::assert_eq(t.get(3U), Option{30U});
+}
+
+SFC_TEST(map_raw_entry) {
+  auto a = HashMap<u32, u32>{};
+  auto b = HashMap<u32, u32>{};
+  for (auto i = 0U; i < 100U; ++i) {
+    const auto hx = a.hash_key(i);
+    a.raw_entry(hx, i).or_insert(i);
+    b.raw_entry(hx, i).or_insert(i * 2);
+  }
+
+  for (auto i = 0U; i < 100U; ++i) {
+    const auto hx = a.hash_key(i);
+    sfc::assert_eq(a.raw_get(hx, i), Option{i});
+    sfc::assert_eq(b.raw_get(hx, i), Option{i * 2});
+  }
+  sfc::assert_eq(b.raw_get(b.hash_key(100U), 100U), None{});
+}
+
+SFC_TEST(map_pool_alloc) {
+  auto pool = mem_pool::XPool{alloc::Global{}};
+  {
+    auto t = HashMap<u32, u32, BuildHasher<>, mem_pool::Allocator>::with_capacity(0, mem_pool::Allocator{pool});
+    for (auto i = 0U; i < 100U; ++i) {
+      t.insert(i, i * 10);
+    }
+    sfc::assert_eq(t.get(99U), Option{990U});
+    sfc::assert_gt(pool.total_bytes(), 0U);
+  }
+  sfc::assert_eq(pool.free_bytes(), pool.total_bytes());
+}
+
+SFC_TEST(map_incremental_release) {
+  auto pool = mem_pool::XPool{alloc::Global{}};
+  {
+    auto t = HashMap<u32, u32, BuildHasher<>, mem_pool::Allocator>::with_capacity(0, mem_pool::Allocator{pool});
+    t.set_incremental_resize(true);
+    for (auto i = 0U; i < 97U; ++i) {
+      t.insert(i, i);
+    }
+    t.clear();
+    sfc::assert_eq(t.len(), 0U);
+    for (auto i = 0U; i < 1000U; ++i) {
+      t.insert(i, i);
+    }
+    sfc::assert_eq(t.get(999U), Option{999U});
+  }
+  sfc::assert_eq(pool.free_bytes(), pool.total_bytes());
+}
+
 }  // namespace sfc::collections::hash::test
@@ -4,21 +4,30 @@
 
 namespace sfc::collections::hash {
 
-template <class K, class V>
+template <class K, class V, class H = BuildHasher<>, class A = alloc::Global>
 class HashMap {
-  struct Entry {
+  struct Item {
     K key;
     V val;
   };
-  HashTbl<Entry> _inn;
+  using Tbl = HashTbl<Item, H, A>;
+  Tbl _inn;
 
  public:
-  static auto with_capacity(usize min_capacity) -> HashMap {
-    auto res = HashMap{};
+  HashMap() noexcept = default;
+
+  explicit HashMap(H hash, A alloc = {}) noexcept : _inn{mem::move(hash), mem::move(alloc)} {}
+
+  static auto with_capacity(usize min_capacity, A alloc = {}) -> HashMap {
+    auto res = HashMap{H{}, mem::move(alloc)};
     res._inn.reserve(min_capacity);
     return res;
   }
 
+  static auto with_hasher(H hash, A alloc = {}) -> HashMap {
+    return HashMap{mem::move(hash), mem::move(alloc)};
+  }
+
   auto len() const noexcept -> usize {
     return _inn.len();
   }
@@ -31,6 +40,24 @@ class HashMap {
     _inn.reserve(additional);
   }
 
+  void shrink_to(usize min_capacity) {
+    _inn.shrink_to(min_capacity);
+  }
+
+  void shrink_to_fit() {
+    _inn.shrink_to_fit();
+  }
+
+  // spread each resize over later operations, bounding the cost of any single one
+  void set_incremental_resize(bool incremental) {
+    _inn.set_incremental(incremental);
+  }
+
+  // probe lengths, tombstones and memory use; scans the whole table
+  auto stats() const -> TblStats {
+    return _inn.stats();
+  }
+
  public:
   auto contains_key(const auto& key) const noexcept -> bool {
     const auto p = _inn.search(key);
@@ -59,9 +86,11 @@ class HashMap {
   }
 
   auto insert(K key, V val) noexcept -> Option<V> {
-    if (auto* p = _inn.try_insert({mem::move(key), mem::move(val)})) {
-      return mem::replace(p->val, mem::move(val));
+    const auto slot = _inn.search_slot(_inn.hash_of(key), key);
+    if (slot.ptr) {
+      return mem::replace(slot.ptr->val, mem::move(val));
     }
+    _inn.insert_slot(slot, {mem::move(key), mem::move(val)});
     return {};
   }
 
@@ -73,24 +102,167 @@ class HashMap {
     _inn.clear();
   }
 
+ public:
+  class OccupiedEntry {
+    Tbl* _tbl;
+    Item* _item;
+    usize _idx;
+
+   public:
+    OccupiedEntry(Tbl& tbl, Item& item, usize idx) noexcept : _tbl{&tbl}, _item{&item}, _idx{idx} {}
+
+    auto key() const noexcept -> const K& {
+      return _item->key;
+    }
+
+    auto get() const noexcept -> const V& {
+      return _item->val;
+    }
+
+    auto get_mut() noexcept -> V& {
+      return _item->val;
+    }
+
+    auto insert(V val) noexcept -> V {
+      return mem::replace(_item->val, mem::move(val));
+    }
+
+    auto remove() noexcept -> V {
+      auto item = _tbl->erase_slot(_idx);
+      return mem::move(item.val);
+    }
+  };
+
+  class VacantEntry {
+    Tbl* _tbl;
+    typename Tbl::Slot _slot;
+    K _key;
+
+   public:
+    VacantEntry(Tbl& tbl, const typename Tbl::Slot& slot, K key) noexcept
+        : _tbl{&tbl}, _slot{slot}, _key{mem::move(key)} {}
+
+    auto key() const noexcept -> const K& {
+      return _key;
+    }
+
+    auto insert(V val) noexcept -> V& {
+      auto& item = _tbl->insert_slot(_slot, {mem::move(_key), mem::move(val)});
+      return item.val;
+    }
+  };
+
+  // a view of one slot, found by a single probe: occupied if the key is present
+  class Entry {
+    Tbl* _tbl;
+    typename Tbl::Slot _slot;
+    K _key;
+
+   public:
+    Entry(Tbl& tbl, const typename Tbl::Slot& slot, K key) noexcept
+        : _tbl{&tbl}, _slot{slot}, _key{mem::move(key)} {}
+
+    auto is_occupied() const noexcept -> bool {
+      return _slot.ptr != nullptr;
+    }
+
+    auto is_vacant() const noexcept -> bool {
+      return _slot.ptr == nullptr;
+    }
+
+    auto key() const noexcept -> const K& {
+      return _slot.ptr ? _slot.ptr->key : _key;
+    }
+
+    auto occupied() noexcept -> OccupiedEntry {
+      sfc::assert_(_slot.ptr != nullptr, "HashMap::Entry::occupied: vacant entry");
+      return OccupiedEntry{*_tbl, *_slot.ptr, _slot.idx};
+    }
+
+    auto vacant() noexcept -> VacantEntry {
+      sfc::assert_(_slot.ptr == nullptr, "HashMap::Entry::vacant: occupied entry");
+      return VacantEntry{*_tbl, _slot, mem::move(_key)};
+    }
+
+    auto or_insert(V val) noexcept -> V& {
+      if (_slot.ptr) {
+        return _slot.ptr->val;
+      }
+      return this->vacant().insert(mem::move(val));
+    }
+
+    auto or_insert_with(auto&& f) -> V& {
+      if (_slot.ptr) {
+        return _slot.ptr->val;
+      }
+      return this->vacant().insert(f());
+    }
+
+    auto or_default() noexcept -> V& {
+      return this->or_insert_with([] { return V{}; });
+    }
+
+    auto and_modify(auto&& f) -> Entry& {
+      if (_slot.ptr) {
+        f(_slot.ptr->val);
+      }
+      return *this;
+    }
+  };
+
+  auto entry(K key) noexcept -> Entry {
+    const auto hash = _inn.hash_of(key);
+    return this->raw_entry(hash, mem::move(key));
+  }
+
+ public:
+  // hash a key once with `hash_key`, then reuse it against every map sharing the same hasher
+  auto hash_key(const auto& key) const noexcept -> u64 {
+    return _inn.hash_of(key);
+  }
+
+  auto raw_get(u64 hash, const auto& key) const noexcept -> Option<const V&> {
+    if (auto* p = _inn.search_hashed(hash, key)) {
+      return p->val;
+    }
+    return {};
+  }
+
+  auto raw_get_mut(u64 hash, const auto& key) noexcept -> Option<V&> {
+    if (auto* p = _inn.search_hashed(hash, key)) {
+      return p->val;
+    }
+    return {};
+  }
+
+  auto raw_entry(u64 hash, K key) noexcept -> Entry {
+    const auto slot = _inn.search_slot(hash, key);
+    return Entry{_inn, slot, mem::move(key)};
+  }
+
+  // calls `f(key, val)` for every entry, in slot order
+  void for_each(auto&& f) const {
+    _inn.iter().for_each([&](const Item& entry) { f(entry.key, entry.val); });
+  }
+
  public:
   // trait: fmt::Display
   void fmt(auto& f) const {
     auto imp = f.debug_map();
-    _inn.iter().for_each([&](const Entry& entry) { imp.entry(entry.key, entry.val); });
+    _inn.iter().for_each([&](const Item& entry) { imp.entry(entry.key, entry.val); });
   }
 
   // trait: serde::Serialize
   void serialize(auto& ser) const {
     auto imp = ser.serialize_obj();
-    _inn.iter().for_each([&](const Entry& entry) { imp.serialize_entry(entry.key, entry.val); });
+    _inn.iter().for_each([&](const Item& entry) { imp.serialize_entry(entry.key, entry.val); });
   }
 
   // trait: serde::Deserialize
   template <class D>
   static auto deserialize(D& des) {
     auto visit = [&](auto& map) { return map.template collect<HashMap, K, V>(); };
-    return des.deserialize_map(visit);
+    return des.deserialize_obj(visit);
   }
 };
 
@@ -4,20 +4,28 @@
 
 namespace sfc::collections::hash {
 
-template <class T>
+template <class T, class H = BuildHasher<>, class A = alloc::Global>
 class HashSet {
   struct Entry {
     T key;
   };
-  HashTbl<Entry> _inn = {};
+  HashTbl<Entry, H, A> _inn = {};
 
  public:
-  static auto with_capacity(usize min_capacity) noexcept -> HashSet {
-    auto res = HashSet{};
+  HashSet() noexcept = default;
+
+  explicit HashSet(H hash, A alloc = {}) noexcept : _inn{mem::move(hash), mem::move(alloc)} {}
+
+  static auto with_capacity(usize min_capacity, A alloc = {}) noexcept -> HashSet {
+    auto res = HashSet{H{}, mem::move(alloc)};
     res._inn.reserve(min_capacity);
     return res;
   }
 
+  static auto with_hasher(H hash, A alloc = {}) -> HashSet {
+    return HashSet{mem::move(hash), mem::move(alloc)};
+  }
+
   auto len() const noexcept -> usize {
     return _inn.len();
   }
@@ -30,6 +38,24 @@ class HashSet {
     _inn.reserve(additional);
   }
 
+  void shrink_to(usize min_capacity) {
+    _inn.shrink_to(min_capacity);
+  }
+
+  void shrink_to_fit() {
+    _inn.shrink_to_fit();
+  }
+
+  // spread each resize over later operations, bounding the cost of any single one
+  void set_incremental_resize(bool incremental) {
+    _inn.set_incremental(incremental);
+  }
+
+  // probe lengths, tombstones and memory use; scans the whole table
+  auto stats() const -> TblStats {
+    return _inn.stats();
+  }
+
  public:
   auto contains(const auto& val) const noexcept -> bool {
     return _inn.search(val) != nullptr;
@@ -53,7 +79,7 @@ class HashSet {
   // trait: fmt::Display
   void fmt(auto& f) const {
     auto imp = f.debug_set();
-    _inn.for_each([&](const Entry& entry) { imp.entry(entry.key); });
+    _inn.iter().for_each([&](const Entry& entry) { imp.entry(entry.key); });
   }
 };
 
@@ -0,0 +1,62 @@
+#pragma once
+
+#include "sfc/core.h"
+
+namespace sfc::collections::hash {
+
+// A snapshot of a hash table's shape, taken on demand by `stats()`.
+// Probe lengths count the groups a lookup loads before it reaches the entry, so 1 is the best case;
+// `probe_hist[i]` holds the entries found in `i + 1` groups, the last bin everything longer.
+struct TblStats {
+  static constexpr usize kProbeBins = 8;
+
+  usize len = 0;
+  usize capacity = 0;
+  usize tombstones = 0;
+  f64 load_factor = 0.0;
+  f64 avg_probe = 0.0;
+  usize max_probe = 0;
+  usize probe_hist[kProbeBins] = {};
+  u64 rehashes = 0;
+  usize bytes = 0;  // table storage only, memory owned by the entries is not counted
+
+ public:
+  void add_probe(usize groups) noexcept {
+    probe_hist[cmp::min(groups, kProbeBins) - 1] += 1;
+    max_probe = cmp::max(max_probe, groups);
+  }
+
+  // trait: fmt::Display
+  void fmt(auto& f) const {
+    f.debug_struct("TblStats")
+        .field("len", len)
+        .field("capacity", capacity)
+        .field("tombstones", tombstones)
+        .field("load_factor", load_factor)
+        .field("avg_probe", avg_probe)
+        .field("max_probe", max_probe)
+        .field("probe_hist", probe_hist)
+        .field("rehashes", rehashes)
+        .field("bytes", bytes);
+  }
+
+  // trait: serde::Serialize
+  void serialize(auto& ser) const {
+    auto imp = ser.serialize_obj();
+    imp.serialize_entry("len", len);
+    imp.serialize_entry("capacity", capacity);
+    imp.serialize_entry("tombstones", tombstones);
+    imp.serialize_entry("load_factor", load_factor);
+    imp.serialize_entry("avg_probe", avg_probe);
+    imp.serialize_entry("max_probe", max_probe);
+    imp.serialize_entry("probe_hist", probe_hist);
+    imp.serialize_entry("rehashes", rehashes);
+    imp.serialize_entry("bytes", bytes);
+  }
+};
+
+}  // namespace sfc::collections::hash
+
+namespace sfc::collections {
+using hash::TblStats;
+}  // namespace sfc::collections
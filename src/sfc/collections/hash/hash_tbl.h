@@ -1,27 +1,46 @@
 #pragma once
 
 #include "sfc/alloc/alloc.h"
+#include "sfc/alloc/boxed.h"
+#include "sfc/collections/hash/hash_group.h"
+#include "sfc/collections/hash/hash_stats.h"
 
 namespace sfc::collections::hash {
 
-static constexpr u8 CTRL_NUL = 0x80U;
-static constexpr u8 CTRL_DEL = 0xFFU;
-
 template <class T>
 struct Iter : iter::Iterator<T&> {
   const u8* _ctrl;
   T* _data;
   usize _cap = 0;
-  usize _idx = 0;
+  usize _pos = 0;
+  usize _base = 0;
+  BitMask _full = {};
+
+  // a second table still being drained by an incremental resize
+  const u8* _rest_ctrl = nullptr;
+  T* _rest_data = nullptr;
+  usize _rest_cap = 0;
 
  public:
   auto next() -> Option<T&> {
-    for (; _idx < _cap; _idx++) {
-      if (_ctrl[_idx] < CTRL_NUL) {
-        return _data[_idx++];
+    while (true) {
+      if (auto i = _full.next()) {
+        return _data[_base + *i];
+      }
+      if (_pos >= _cap) {
+        if (_rest_cap == 0) {
+          return {};
+        }
+        _ctrl = mem::take(_rest_ctrl);
+        _data = mem::take(_rest_data);
+        _cap = mem::take(_rest_cap);
+        _pos = 0;
+        continue;
       }
+      _base = _pos;
+      _full = Group::load(_ctrl + _pos).match_full().truncate(_cap - _pos);
+      _pos += Group::WIDTH;
     }
-    return {};
   }
 };
 
@@ -41,22 +60,28 @@ struct Bucket {
   };
 
   auto search_nul() const -> usize {
-    for (auto i = 0U; i <= _mask; ++i) {
-      const auto k = (_hidx + i) & _mask;
-      if (_ctrl[k] == CTRL_NUL) {
-        return k;
+    auto pos = _hidx;
+    for (auto stride = 0UL; stride <= _mask; stride += Group::WIDTH, pos = (pos + stride) & _mask) {
+      const auto grp = Group::load(_ctrl + pos);
+      if (const auto m = grp.match_empty_or_deleted()) {
+        return this->fix_insert_idx((pos + m.lowest()) & _mask);
       }
     }
     return kInvalidIdx;
   }
 
   auto search_key(u8 h2, const auto& key) const -> SearchResult {
-    for (auto i = 0U; i <= _mask; ++i) {
-      const auto k = (_hidx + i) & _mask;
-      const auto c = _ctrl[k];
-      if (c == h2 && _data[k].key == key) {  // found
-        return {&_data[k], k};
-      } else if (c == CTRL_NUL) {  // not found
+    auto pos = _hidx;
+    for (auto stride = 0UL; stride <= _mask; stride += Group::WIDTH, pos = (pos + stride) & _mask) {
+      const auto grp = Group::load(_ctrl + pos);
+      auto m = grp.match_byte(h2);
+      while (auto i = m.next()) {
+        const auto k = (pos + *i) & _mask;
+        if (_data[k].key == key) {  // found
+          return {&_data[k], k};
+        }
+      }
+      if (grp.match_empty()) {  // not found
         return {nullptr, 0};
       }
     }
@@ -64,77 +89,122 @@ struct Bucket {
   }
 
   auto search_for_insert(u8 h2, const auto& key) const -> SearchResult {
-    auto del_idx = kInvalidIdx;
-
-    for (auto i = 0U; i <= _mask; ++i) {
-      const auto k = (_hidx + i) & _mask;
-      const auto c = _ctrl[k];
-      if (c == h2 && _data[k].key == key) {
-        return {&_data[k], k};
-      } else if (c == CTRL_NUL) {
-        const auto ins_idx = del_idx != kInvalidIdx ? del_idx : k;
+    auto ins_idx = kInvalidIdx;
+
+    auto pos = _hidx;
+    for (auto stride = 0UL; stride <= _mask; stride += Group::WIDTH, pos = (pos + stride) & _mask) {
+      const auto grp = Group::load(_ctrl + pos);
+      auto m = grp.match_byte(h2);
+      while (auto i = m.next()) {
+        const auto k = (pos + *i) & _mask;
+        if (_data[k].key == key) {
+          return {&_data[k], k};
+        }
+      }
+      if (ins_idx == kInvalidIdx) {
+        if (const auto e = grp.match_empty_or_deleted()) {
+          ins_idx = this->fix_insert_idx((pos + e.lowest()) & _mask);
+        }
+      }
+      if (grp.match_empty()) {
         return {nullptr, ins_idx};
-      } else if (c == CTRL_DEL && del_idx == kInvalidIdx) {
-        del_idx = k;
       }
     }
-    return {nullptr, kInvalidIdx};
+    return {nullptr, ins_idx};
+  }
+
+  void set_ctrl(usize pos, u8 ctrl) {
+    // the first WIDTH bytes are mirrored after the end, so any group load stays in bounds
+    _ctrl[pos] = ctrl;
+    _ctrl[((pos - Group::WIDTH) & _mask) + Group::WIDTH] = ctrl;
   }
 
   void insert_at(usize pos, u8 h2, T&& val) {
-    _ctrl[pos] = h2;
+    this->set_ctrl(pos, h2);
     ptr::write(_data + pos, mem::move(val));
   }
 
+  // a slot no probe sequence has passed over can go straight back to empty
   auto erase_at(usize pos) -> T {
     auto res = ptr::read(_data + pos);
-    _ctrl[pos] = CTRL_DEL;
+    const auto empty_before = Group::load(_ctrl + ((pos - Group::WIDTH) & _mask)).match_empty();
+    const auto empty_after = Group::load(_ctrl + pos).match_empty();
+    const auto was_in_full_run = empty_before.leading_zeros() + empty_after.trailing_zeros() >= Group::WIDTH;
+    this->set_ctrl(pos, was_in_full_run ? CTRL_DEL : CTRL_NUL);
     return res;
   }
 
-  auto remove(u8 h2, const auto& key) -> Option<T> {
-    const auto [ptr, idx] = this->search_key(h2, key);
-    if (!ptr) return {};
-    return this->erase_at(idx);
-  }
-
-  auto try_insert(u8 h2, T&& entry) -> T* {
-    const auto [ptr, idx] = this->search_for_insert(h2, entry.key);
-    if (!ptr) {
-      this->insert_at(idx, h2, mem::move(entry));
-      return nullptr;
-    }
-    return ptr;
-  }
-
-  auto insert_new(u8 h2, T&& entry) -> bool {
-    const auto idx = this->search_nul();
-    if (idx == kInvalidIdx) {
-      return false;
+ private:
+  auto fix_insert_idx(usize idx) const -> usize {
+    // tables smaller than a group see the padding bytes as empty, which may alias a full slot
+    if (is_full(_ctrl[idx])) {
+      return Group::load(_ctrl).match_empty_or_deleted().lowest();
     }
-    this->insert_at(idx, h2, mem::move(entry));
-    return true;
+    return idx;
   }
 };
 
+template <class A = alloc::Global>
 class HashTblStorage {
-  using A = alloc::Global;
   static constexpr usize kAlign = 16U;
+  static constexpr usize kMinCap = 8U;
 
   u8* _ptr{nullptr};
   usize _cap{0};
+  usize _elem_size{0};
   [[no_unique_address]] A _alloc{};
 
  public:
-  HashTblStorage();
-  ~HashTblStorage();
+  HashTblStorage(A alloc = {}) noexcept : _alloc{mem::move(alloc)} {}
+
+  ~HashTblStorage() noexcept {
+    if (_ptr == nullptr) {
+      return;
+    }
+    _alloc.deallocate(_ptr, this->layout());
+  }
 
-  HashTblStorage(HashTblStorage&& other) noexcept;
-  HashTblStorage& operator=(HashTblStorage&& other) noexcept;
+  HashTblStorage(HashTblStorage&& other) noexcept
+      : _ptr{mem::take(other._ptr)},
+        _cap{mem::take(other._cap)},
+        _elem_size{mem::take(other._elem_size)},
+        _alloc{mem::move(other._alloc)} {}
+
+  HashTblStorage& operator=(HashTblStorage&& other) noexcept {
+    if (this != &other) {
+      mem::swap(_ptr, other._ptr);
+      mem::swap(_cap, other._cap);
+      mem::swap(_elem_size, other._elem_size);
+      mem::swap(_alloc, other._alloc);
+    }
+    return *this;
+  }
 
-  static auto with_capacity(usize min_cap, usize element_size) -> HashTblStorage;
+  static auto with_capacity(usize min_cap, usize element_size, A alloc = {}) -> HashTblStorage {
+    auto res = HashTblStorage{mem::move(alloc)};
+    if (min_cap == 0) {
+      return res;
+    }
 
-  void init(usize element_size);
+    res._cap = HashTblStorage::capacity_for(min_cap);
+    res._elem_size = element_size;
+    res._ptr = ptr::cast<u8>(res._alloc.allocate(res.layout()));
+    return res;
+  }
+
+  static auto capacity_for(usize min_cap) noexcept -> usize {
+    if (min_cap == 0) {
+      return 0;
+    }
+    return num::next_power_of_two(cmp::max(min_cap, kMinCap));
+  }
+
+  void init() {
+    if (_ptr == nullptr) {
+      return;
+    }
+    ptr::write_bytes(_ptr, CTRL_NUL, HashTblStorage::ctrl_size(_cap));
+  }
 
  public:
   auto cap() const noexcept -> usize {
@@ -149,32 +219,77 @@ class HashTblStorage {
     return _ptr;
   }
 
+  auto allocator() const noexcept -> const A& {
+    return _alloc;
+  }
+
   template <class T>
   auto data() const noexcept -> T* {
-    const auto offset = num::align_up(_cap, kAlign);
+    if (_ptr == nullptr) {
+      return nullptr;
+    }
+    const auto offset = HashTblStorage::ctrl_size(_cap);
     return ptr::cast<T>(_ptr + offset);
   }
+
+  auto allocated_bytes() const noexcept -> usize {
+    return _ptr ? this->layout().size : 0;
+  }
+
+  // one ctrl byte per slot, plus a group of mirrored bytes for unaligned group loads
+  static auto ctrl_size(usize cap) noexcept -> usize {
+    return num::align_up(cap + Group::WIDTH, kAlign);
+  }
+
+ private:
+  auto layout() const noexcept -> mem::Layout {
+    return mem::Layout{HashTblStorage::ctrl_size(_cap) + _cap * _elem_size, kAlign};
+  }
 };
 
-template <class T>
+template <class T, class H = BuildHasher<>, class A = alloc::Global>
 class HashTbl {
-  using RawTbl = HashTblStorage;
+  using RawTbl = HashTblStorage<A>;
   static constexpr f64 kLoadFactor = 0.75;
+  static constexpr usize kMigrateSlots = 32;
 
   RawTbl _buf;
   usize _len{0};
-  usize _rem{0};
+  usize _rem{0};  // inserts left before the load factor is hit, tombstones excluded
+  usize _del{0};  // tombstones
+  u64 _rehashes{0};
+
+  // incremental resize: entries left in the previous storage, drained from `pos` on
+  struct Resize {
+    RawTbl old;
+    usize pos;
+    usize len;
+  };
+  Box<Resize> _resize{};  // allocated when the mode is enabled, so other tables pay one word
+
+  [[no_unique_address]] H _hash{};
 
  public:
   HashTbl() noexcept = default;
 
+  explicit HashTbl(H hash, A alloc = {}) noexcept : _buf{mem::move(alloc)}, _hash{mem::move(hash)} {}
+
   ~HashTbl() noexcept {
     this->clear();
   }
 
-  HashTbl(HashTbl&& other) noexcept : _buf{mem::move(other._buf)}, _len{other._len}, _rem{other._rem} {
+  HashTbl(HashTbl&& other) noexcept
+      : _buf{mem::move(other._buf)},
+        _len{other._len},
+        _rem{other._rem},
+        _del{other._del},
+        _rehashes{other._rehashes},
+        _resize{mem::move(other._resize)},
+        _hash{mem::move(other._hash)} {
     other._len = 0;
     other._rem = 0;
+    other._del = 0;
+    other._rehashes = 0;
   }
 
   HashTbl& operator=(HashTbl&& other) noexcept {
@@ -182,12 +297,16 @@ class HashTbl {
     mem::swap(_buf, other._buf);
     mem::swap(_len, other._len);
     mem::swap(_rem, other._rem);
+    mem::swap(_del, other._del);
+    mem::swap(_rehashes, other._rehashes);
+    mem::swap(_resize, other._resize);
+    mem::swap(_hash, other._hash);
     return *this;
   }
 
-  static auto with_capacity(usize min_cap) -> HashTbl {
-    auto res = HashTbl{};
-    res._buf = RawTbl::with_capacity(min_cap, sizeof(T));
+  static auto with_capacity(usize min_cap, H hash = {}, A alloc = {}) -> HashTbl {
+    auto res = HashTbl{mem::move(hash)};
+    res._buf = RawTbl::with_capacity(min_cap, sizeof(T), mem::move(alloc));
     res.init();
     return res;
   }
@@ -200,38 +319,188 @@ class HashTbl {
     return _buf.cap();
   }
 
+  auto tombstones() const noexcept -> usize {
+    return _del;
+  }
+
+  auto is_resizing() const noexcept -> bool {
+    return this->old_len() != 0;
+  }
+
+  // opt-in: grow into new storage and move a few old slots on each insert/remove,
+  // instead of moving every entry in the insert that crosses the load factor
+  void set_incremental(bool incremental) {
+    if (!incremental) {
+      this->finish_resize();
+      _resize = {};
+    } else if (_resize.is_null()) {
+      _resize = Box<Resize>::new_(RawTbl{_buf.allocator()}, 0UL, 0UL);
+    }
+  }
+
+  // Walks every slot to measure probe lengths, so it costs a full scan: meant for diagnostics.
+  auto stats() const -> TblStats {
+    auto res = TblStats{
+        .len = _len,
+        .capacity = _buf.cap(),
+        .tombstones = _del,
+        // entries still in the old storage of an incremental resize do not load the new one
+        .load_factor = _buf.cap() ? f64(_len - this->old_len()) / f64(_buf.cap()) : 0.0,
+        .rehashes = _rehashes,
+        .bytes = this->allocated_bytes(),
+    };
+
+    auto total = 0UL;
+    const auto visit = [&](const RawTbl& raw) {
+      const auto ctrl = raw.ctrl();
+      const auto data = raw.template data<T>();
+      for (auto i = 0UL; i < raw.cap(); ++i) {
+        if (!is_full(ctrl[i])) {
+          continue;
+        }
+        const auto groups = HashTbl::probe_groups(raw.mask(), this->hash_of(data[i].key) & raw.mask(), i);
+        res.add_probe(groups);
+        total += groups;
+      }
+    };
+    visit(_buf);
+    if (const auto old = this->old_storage()) {
+      visit(*old);
+    }
+
+    if (_len != 0) {
+      res.avg_probe = f64(total) / f64(_len);
+    }
+    return res;
+  }
+
+  // the bytes held by the table storage, the old storage of an incremental resize included
+  auto allocated_bytes() const noexcept -> usize {
+    return _buf.allocated_bytes() + (_resize.is_null() ? 0 : _resize->old.allocated_bytes());
+  }
+
+  auto hasher() const noexcept -> const H& {
+    return _hash;
+  }
+
+  auto allocator() const noexcept -> const A& {
+    return _buf.allocator();
+  }
+
+  auto hash_of(const auto& key) const noexcept -> u64 {
+    return _hash.hash_one(key);
+  }
+
   auto search(const auto& key) const -> T* {
     if (_len == 0) {
       return nullptr;
     }
+    return this->search_hashed(this->hash_of(key), key);
+  }
+
+  auto search_hashed(u64 hx, const auto& key) const -> T* {
+    if (_len == 0) {
+      return nullptr;
+    }
 
-    const auto [h1, h2] = this->hidx(key);
-    return this->bucket(h1).search_key(h2, key).ptr;
+    const auto [h1, h2] = this->hidx(hx);
+    if (auto p = this->bucket(h1).search_key(h2, key).ptr) {
+      return p;
+    }
+    if (this->old_len() != 0) {
+      return this->old_bucket(hx).search_key(h2, key).ptr;
+    }
+    return nullptr;
   }
 
-  auto try_insert(T&& entry) noexcept -> T* {
+  struct Slot {
+    T* ptr;  // the matching entry, or null if vacant
+    usize idx;
+    u8 h2;
+  };
+
+  // one probe for both lookup and insertion: an occupied slot, or where the key would go.
+  // Only a vacant slot that needs an empty byte with no room left makes room and probes again.
+  auto search_slot(u64 hx, const auto& key) noexcept -> Slot {
+    this->migrate(kMigrateSlots);
+
+    const auto [h1, h2] = this->hidx(hx);
+    if (_buf.cap() != 0) {
+      const auto [ptr, idx] = this->bucket(h1).search_for_insert(h2, key);
+      if (ptr) {
+        return {ptr, idx, h2};
+      }
+      if (_rem != 0 || (idx != Bucket<T>::kInvalidIdx && _buf.ctrl()[idx] == CTRL_DEL)) {
+        return this->vacant_slot(hx, {nullptr, idx, h2}, key);
+      }
+    }
+
     this->reserve(1);
+    const auto idx = this->bucket(hx & _buf.mask()).search_for_insert(h2, key).idx;
+    return this->vacant_slot(hx, {nullptr, idx, h2}, key);
+  }
 
-    const auto [h1, h2] = this->hidx(entry.key);
-    const auto ptr = this->bucket(h1).try_insert(h2, mem::move(entry));
-    if (!ptr) {
-      _len += 1;
+  auto insert_slot(const Slot& slot, T&& entry) noexcept -> T& {
+    // reusing a tombstone does not bring the table closer to its load factor
+    if (_buf.ctrl()[slot.idx] == CTRL_DEL) {
+      _del -= 1;
+    } else {
       _rem -= 1;
     }
-    return ptr;
+    this->bucket(slot.idx).insert_at(slot.idx, slot.h2, mem::move(entry));
+    _len += 1;
+    return _buf.template data<T>()[slot.idx];
+  }
+
+  auto erase_slot(usize idx) noexcept -> T {
+    auto res = this->bucket(idx).erase_at(idx);
+    if (_buf.ctrl()[idx] == CTRL_DEL) {
+      _del += 1;
+    } else {
+      _rem += 1;
+    }
+    _len -= 1;
+    return res;
+  }
+
+  auto try_insert(T&& entry) noexcept -> T* {
+    const auto slot = this->search_slot(this->hash_of(entry.key), entry.key);
+    if (slot.ptr) {
+      return slot.ptr;
+    }
+    this->insert_slot(slot, mem::move(entry));
+    return nullptr;
   }
 
   auto remove(const auto& key) noexcept -> Option<T> {
     if (_len == 0) {
       return {};
     }
+    return this->remove_hashed(this->hash_of(key), key);
+  }
+
+  auto remove_hashed(u64 hx, const auto& key) noexcept -> Option<T> {
+    if (_len == 0) {
+      return {};
+    }
+    this->migrate(kMigrateSlots);
 
-    const auto [h1, h2] = this->hidx(key);
-    auto ret = this->bucket(h1).remove(h2, key);
-    if (ret) {
-      _len -= 1;
+    const auto [h1, h2] = this->hidx(hx);
+    const auto [ptr, idx] = this->bucket(h1).search_key(h2, key);
+    if (ptr) {
+      return this->erase_slot(idx);
     }
-    return ret;
+    if (this->old_len() == 0) {
+      return {};
+    }
+
+    const auto old = this->old_bucket(hx).search_key(h2, key);
+    if (!old.ptr) {
+      return {};
+    }
+    auto res = this->take_old(old.idx);
+    this->release_old();
+    return res;
   }
 
   void clear() noexcept {
@@ -239,6 +508,10 @@ class HashTbl {
       return;
     }
     this->iter_mut().for_each([&](T& entry) { entry.~T(); });
+    if (!_resize.is_null()) {
+      _resize->len = 0;
+      this->release_old();
+    }
     this->init();
   }
 
@@ -246,41 +519,207 @@ class HashTbl {
     if (additional <= _rem) {
       return;
     }
+    this->finish_resize();
+
+    // mostly tombstones: reclaim them at the same capacity instead of growing
+    const auto new_len = _len + additional;
+    if (_del != 0 && new_len <= this->max_load() / 2) {
+      this->rehash_in_place();
+      return;
+    }
+    this->resize(cmp::max(new_len, this->max_load() + 1));
+  }
+
+  void shrink_to(usize min_len) {
+    this->finish_resize();
+
+    const auto new_len = cmp::max(_len, min_len);
+    const auto new_cap = RawTbl::capacity_for(HashTbl::cap_for_len(new_len));
+    if (new_cap >= _buf.cap()) {
+      return;
+    }
+    this->resize(new_len);
+  }
 
-    this->rehash(_len + additional);
+  void shrink_to_fit() {
+    this->shrink_to(0);
   }
 
   using Iter = hash::Iter<const T>;
   auto iter() const -> Iter {
-    return {{}, _buf.ctrl(), _buf.data<T>(), _buf.cap()};
+    const auto old = this->old_storage();
+    return {{}, _buf.ctrl(), _buf.template data<T>(), _buf.cap(), 0, 0, {},
+            old ? old->ctrl() : nullptr, old ? old->template data<T>() : nullptr, old ? old->cap() : 0};
   }
 
   using IterMut = hash::Iter<T>;
   auto iter_mut() -> IterMut {
-    return {{}, _buf.ctrl(), _buf.data<T>(), _buf.cap()};
+    const auto old = this->old_storage();
+    return {{}, _buf.ctrl(), _buf.template data<T>(), _buf.cap(), 0, 0, {},
+            old ? old->ctrl() : nullptr, old ? old->template data<T>() : nullptr, old ? old->cap() : 0};
   }
 
  private:
-  auto hidx(const auto& key) const noexcept -> Tuple<usize, u8> {
-    const auto hx = Hash::hash(key);
+  auto hidx(u64 hx) const noexcept -> Tuple<usize, u8> {
     const auto h1 = hx & (_buf.mask());
     const auto h2 = u8((hx >> 57) & 0x7F);
     return {h1, h2};
   }
 
   auto bucket(usize h1) const -> Bucket<T> {
-    return Bucket{_buf.ctrl(), _buf.data<T>(), _buf.mask(), h1};
+    return Bucket{_buf.ctrl(), _buf.template data<T>(), _buf.mask(), h1};
+  }
+
+  auto old_len() const noexcept -> usize {
+    return _resize.is_null() ? 0 : _resize->len;
+  }
+
+  // the storage still being drained, null if none
+  auto old_storage() const noexcept -> const RawTbl* {
+    return this->old_len() != 0 ? &_resize->old : nullptr;
+  }
+
+  auto old_bucket(u64 hx) const -> Bucket<T> {
+    const auto& old = _resize->old;
+    return Bucket{old.ctrl(), old.template data<T>(), old.mask(), hx & old.mask()};
+  }
+
+  // a key not migrated yet is moved over, so the slot always refers to the current storage
+  auto vacant_slot(u64 hx, const Slot& slot, const auto& key) -> Slot {
+    if (this->old_len() == 0) {
+      return slot;
+    }
+    const auto old = this->old_bucket(hx).search_key(slot.h2, key);
+    if (!old.ptr) {
+      return slot;
+    }
+    auto& entry = this->insert_slot(slot, this->take_old(old.idx));
+    this->release_old();
+    return {&entry, slot.idx, slot.h2};
+  }
+
+  auto take_old(usize idx) -> T {
+    _resize->len -= 1;
+    _len -= 1;
+    return this->old_bucket(0).erase_at(idx);
+  }
+
+  void release_old() {
+    if (_resize->len != 0) {
+      return;
+    }
+    _resize->old = RawTbl{_buf.allocator()};
+    _resize->pos = 0;
+  }
+
+  // move up to `max_slots` slots of the old storage into the current one
+  void migrate(usize max_slots) {
+    if (this->old_len() == 0) {
+      return;
+    }
+
+    auto& r = *_resize;
+    const auto ctrl = r.old.ctrl();
+    const auto end = cmp::min(r.pos + max_slots, r.old.cap());
+    for (; r.pos < end && r.len != 0; ++r.pos) {
+      if (is_full(ctrl[r.pos])) {
+        this->rehash_insert(this->take_old(r.pos));
+      }
+    }
+    this->release_old();
+  }
+
+  void finish_resize() {
+    if (const auto old = this->old_storage()) {
+      this->migrate(old->cap());
+    }
   }
 
   void init() {
     _len = 0;
-    _rem = usize(f64(_buf.cap()) * kLoadFactor);
-    _buf.init(sizeof(T));
+    _rem = this->max_load();
+    _del = 0;
+    _buf.init();
   }
 
-  void rehash(usize max_len) {
-    const auto min_cap = usize(f64(max_len) / kLoadFactor + 0.5);
-    auto new_tbl = HashTbl::with_capacity(min_cap);
+  auto max_load() const noexcept -> usize {
+    return usize(f64(_buf.cap()) * kLoadFactor);
+  }
+
+  static auto cap_for_len(usize len) noexcept -> usize {
+    return usize(f64(len) / kLoadFactor + 0.5);
+  }
+
+  // the number of groups the probe sequence from `h1` loads up to and including slot `idx`
+  static auto probe_groups(usize mask, usize h1, usize idx) noexcept -> usize {
+    auto pos = h1;
+    auto res = 1UL;
+    for (auto stride = 0UL; stride <= mask; stride += Group::WIDTH, pos = (pos + stride) & mask, ++res) {
+      if (((idx - pos) & mask) < Group::WIDTH) {
+        break;
+      }
+    }
+    return res;
+  }
+
+  // full slots are marked deleted, then each one is moved to its first free slot or left in place
+  void rehash_in_place() {
+    const auto ctrl = _buf.ctrl();
+    const auto data = _buf.template data<T>();
+    const auto mask = _buf.mask();
+    auto raw = this->bucket(0);
+
+    for (auto i = 0UL; i <= mask; ++i) {
+      raw.set_ctrl(i, is_full(ctrl[i]) ? CTRL_DEL : CTRL_NUL);
+    }
+
+    for (auto i = 0UL; i <= mask; ++i) {
+      while (ctrl[i] == CTRL_DEL) {
+        const auto [h1, h2] = this->hidx(this->hash_of(data[i].key));
+        const auto dst = this->bucket(h1).search_nul();
+
+        // already in the first group of its probe sequence that has room
+        const auto probe_group = [&](usize pos) { return ((pos - h1) & mask) / Group::WIDTH; };
+        if (probe_group(i) == probe_group(dst)) {
+          raw.set_ctrl(i, h2);
+          break;
+        }
+
+        const auto prev = ctrl[dst];
+        raw.set_ctrl(dst, h2);
+        if (prev == CTRL_NUL) {
+          ptr::write(data + dst, ptr::read(data + i));
+          raw.set_ctrl(i, CTRL_NUL);
+          break;
+        }
+
+        // displaced an entry that is still waiting, so place it next
+        mem::swap(data[i], data[dst]);
+      }
+    }
+
+    _del = 0;
+    _rem = this->max_load() - _len;
+    _rehashes += 1;
+  }
+
+  void resize(usize max_len) {
+    const auto min_cap = HashTbl::cap_for_len(max_len);
+    auto new_tbl = HashTbl::with_capacity(min_cap, _hash, _buf.allocator());
+
+    if (!_resize.is_null() && _len != 0 && new_tbl.cap() > _buf.cap()) {
+      // the new storage has room for every old entry plus the inserts made while draining
+      _resize->old = mem::move(_buf);
+      _resize->pos = 0;
+      _resize->len = _len;
+      _buf = mem::move(new_tbl._buf);
+      _rem = this->max_load();
+      _del = 0;
+      _rehashes += 1;
+      return;
+    }
+    new_tbl._resize = mem::move(_resize);
+    new_tbl._rehashes = _rehashes + 1;
 
     // rehash all entries
     this->iter_mut().for_each([&](T& entry) { new_tbl.rehash_insert(mem::move(entry)); });
@@ -292,14 +731,13 @@ class HashTbl {
       return false;
     }
 
-    const auto [h1, h2] = this->hidx(entry.key);
-    const auto ret = this->bucket(h1).insert_new(h2, mem::move(entry));
-    if (!ret) {
+    const auto [h1, h2] = this->hidx(this->hash_of(entry.key));
+    const auto idx = this->bucket(h1).search_nul();
+    if (idx == Bucket<T>::kInvalidIdx) {
       return false;
     }
 
-    _len += 1;
-    _rem -= 1;
+    this->insert_slot({nullptr, idx, h2}, mem::move(entry));
     return true;
   }
 };
@@ -0,0 +1,91 @@
+#include "sfc/collections/hash/index_map.h"
+#include "sfc/test/test.h"
+
+namespace sfc::collections::hash::test {
+
+SFC_TEST(index_map_insert) {
+  auto m = IndexMap<u32, u32>{};
+  for (auto i = 0U; i < 100U; ++i) {
+    sfc::assert_eq(m.insert(99 - i, i), None{});
+  }
+  sfc::assert_eq(m.len(), 100U);
+  sfc::assert_eq(m.insert(50, 0), Option{49U});
+
+  // insertion order, updates keep their position
+  auto i = 0U;
+  m.iter().for_each([&](const auto& entry) {
+    sfc::assert_eq(entry.key, 99 - i);
+    i += 1;
+  });
+  sfc::assert_eq(m.get_index_of(50U), Option{usize{49}});
+  sfc::assert_eq(m.get(50U), Option{0U});
+  sfc::assert_eq(m.get(100U), None{});
+  sfc::assert_eq(m.contains_key(50U), true);
+  sfc::assert_eq(m.contains_key(100U), false);
+  sfc::assert_eq(m.first()->key, 99U);
+  sfc::assert_eq(m.last()->key, 0U);
+}
+
+SFC_TEST(index_map_swap_remove) {
+  auto m = IndexMap<u32, u32>{};
+  for (auto i = 0U; i < 5U; ++i) {
+    m.insert(i, i * 10);
+  }
+
+  sfc::assert_eq(m.swap_remove(1U), Option{10U});
+  sfc::assert_eq(m.swap_remove(1U), None{});
+  sfc::assert_eq(m.get_index_of(4U), Option{usize{1}});
+  sfc::assert_eq(m.get(4U), Option{40U});
+
+  sfc::assert_eq(m.swap_remove(3U), Option{30U});
+  sfc::assert_eq(m.len(), 3U);
+  sfc::assert_eq(m.get_index(2)->key, 2U);
+}
+
+SFC_TEST(index_map_shift_remove) {
+  auto m = IndexMap<u32, u32>{};
+  for (auto i = 0U; i < 5U; ++i) {
+    m.insert(i, i * 10);
+  }
+
+  sfc::assert_eq(m.shift_remove(1U), Option{10U});
+  sfc::assert_eq(m.shift_remove(4U), Option{40U});
+  sfc::assert_eq(m.len(), 3U);
+  sfc::assert_eq(m.get_index_of(0U), Option{usize{0}});
+  sfc::assert_eq(m.get_index_of(2U), Option{usize{1}});
+  sfc::assert_eq(m.get_index_of(3U), Option{usize{2}});
+  sfc::assert_eq(m.get(3U), Option{30U});
+}
+
+SFC_TEST(index_map_churn) {
+  auto m = IndexMap<u32, u32>{};
+  for (auto i = 0U; i < 10000U; ++i) {
+    m.insert(i, i);
+  }
+  for (auto i = 0U; i < 10000U; i += 2) {
+    sfc::assert_eq(m.swap_remove(i), Option{i});
+  }
+  sfc::assert_eq(m.len(), 5000U);
+
+  for (auto i = 0U; i < 10000U; ++i) {
+    if (i % 2 == 0) {
+      sfc::assert_eq(m.get(i), None{});
+    } else {
+      sfc::assert_eq(m.get(i), Option{i});
+      const auto idx = m.get_index_of(i).unwrap();
+      sfc::assert_eq(m.get_index(idx)->key, i);
+    }
+  }
+}
+
+SFC_TEST(index_map_str_key) {
+  auto m = IndexMap<String, u32>{};
+  m.insert(String::from("b"), 2);
+  m.insert(String::from("a"), 1);
+  sfc::assert_eq(m.get(Str{"a"}), Option{1U});
+  sfc::assert_eq(m.first()->key, Str{"b"});
+  sfc::assert_eq(m.shift_remove(Str{"b"}), Option{2U});
+  sfc::assert_eq(m.first()->key, Str{"a"});
+}
+
+}  // namespace sfc::collections::hash::test
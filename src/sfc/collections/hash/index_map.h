@@ -0,0 +1,187 @@
+#pragma once
+
+#include "sfc/alloc/list.h"
+#include "sfc/collections/hash/pos_tbl.h"
+
+namespace sfc::collections::hash {
+
+// A map that keeps its entries densely packed in insertion order.
+// The hash table only holds positions into the entry list, so iteration is a linear scan.
+template <class K, class V, class H = BuildHasher<>, class A = alloc::Global>
+class IndexMap {
+ public:
+  struct Entry {
+    K key;
+    V val;
+  };
+
+ private:
+  List<Entry, A> _entries;
+  PosTbl<A> _indices;
+  [[no_unique_address]] H _hash{};
+
+ public:
+  IndexMap() noexcept = default;
+
+  explicit IndexMap(H hash, A alloc = {}) noexcept
+      : _entries{List<Entry, A>::with_capacity(0, alloc)}, _indices{alloc}, _hash{mem::move(hash)} {}
+
+  static auto with_capacity(usize min_capacity, A alloc = {}) -> IndexMap {
+    auto res = IndexMap{H{}, mem::move(alloc)};
+    res.reserve(min_capacity);
+    return res;
+  }
+
+  static auto with_hasher(H hash, A alloc = {}) -> IndexMap {
+    return IndexMap{mem::move(hash), mem::move(alloc)};
+  }
+
+  auto len() const noexcept -> usize {
+    return _entries.len();
+  }
+
+  auto is_empty() const noexcept -> bool {
+    return _entries.is_empty();
+  }
+
+  auto capacity() const noexcept -> usize {
+    return cmp::min(_entries.capacity(), _indices.cap());
+  }
+
+  void reserve(usize additional) {
+    _entries.reserve(additional);
+    _indices.reserve(additional);
+  }
+
+  auto as_slice() const noexcept -> Slice<const Entry> {
+    return _entries.as_slice();
+  }
+
+ public:
+  auto get_index_of(const auto& key) const noexcept -> Option<usize> {
+    if (const auto idx = this->search(key)) {
+      return usize{*idx};
+    }
+    return {};
+  }
+
+  auto get_index(usize idx) const noexcept -> Option<const Entry&> {
+    if (idx >= _entries.len()) {
+      return {};
+    }
+    return _entries[idx];
+  }
+
+  auto contains_key(const auto& key) const noexcept -> bool {
+    return this->search(key).is_some();
+  }
+
+  auto get(const auto& key) const noexcept -> Option<const V&> {
+    if (const auto idx = this->search(key)) {
+      return _entries[*idx].val;
+    }
+    return {};
+  }
+
+  auto get_mut(const auto& key) noexcept -> Option<V&> {
+    if (const auto idx = this->search(key)) {
+      return _entries[*idx].val;
+    }
+    return {};
+  }
+
+  auto first() const noexcept -> Option<const Entry&> {
+    return _entries.first();
+  }
+
+  auto last() const noexcept -> Option<const Entry&> {
+    return _entries.last();
+  }
+
+  // an existing key keeps its position; a new one is appended
+  auto insert(K key, V val) -> Option<V> {
+    const auto tag = u32(_hash.hash_one(key));
+    const auto idx = _entries.len();
+    sfc::assert_(idx < num::Int<u32>::MAX, "IndexMap::insert: too many entries");
+
+    if (const auto old = _indices.find_or_insert(_entries.as_ptr(), key, tag, u32(idx))) {
+      return mem::replace(_entries[*old].val, mem::move(val));
+    }
+    _entries.push(Entry{mem::move(key), mem::move(val)});
+    return {};
+  }
+
+  // O(1): the last entry takes the removed one's place, so the order is perturbed
+  auto swap_remove(const auto& key) -> Option<V> {
+    const auto pos = this->remove_pos(key);
+    if (!pos) {
+      return {};
+    }
+
+    const auto idx = *pos;
+    const auto last = u32(_entries.len() - 1);
+    if (idx != last) {
+      _indices.relocate(u32(_hash.hash_one(_entries[last].key)), last, idx);
+    }
+    auto entry = _entries.swap_remove(idx);
+    return mem::move(entry.val);
+  }
+
+  // O(n): the following entries shift down by one, so the order is preserved
+  auto shift_remove(const auto& key) -> Option<V> {
+    const auto pos = this->remove_pos(key);
+    if (!pos) {
+      return {};
+    }
+
+    const auto idx = *pos;
+    if (idx + 1 != _entries.len()) {
+      _indices.shift_down(idx);
+    }
+    auto entry = _entries.remove(idx);
+    return mem::move(entry.val);
+  }
+
+  void clear() {
+    _indices.clear();
+    _entries.clear();
+  }
+
+  using Iter = slice::Iter<const Entry>;
+  auto iter() const noexcept -> Iter {
+    return _entries.iter();
+  }
+
+  using IterMut = slice::Iter<Entry>;
+  auto iter_mut() noexcept -> IterMut {
+    return _entries.iter_mut();
+  }
+
+ public:
+  // trait: fmt::Display
+  void fmt(auto& f) const {
+    auto imp = f.debug_map();
+    _entries.iter().for_each([&](const Entry& entry) { imp.entry(entry.key, entry.val); });
+  }
+
+  // trait: serde::Serialize
+  void serialize(auto& ser) const {
+    auto imp = ser.serialize_obj();
+    _entries.iter().for_each([&](const Entry& entry) { imp.serialize_entry(entry.key, entry.val); });
+  }
+
+ private:
+  auto search(const auto& key) const noexcept -> Option<u32> {
+    return _indices.find(_entries.as_ptr(), key, u32(_hash.hash_one(key)));
+  }
+
+  auto remove_pos(const auto& key) -> Option<u32> {
+    return _indices.remove(_entries.as_ptr(), key, u32(_hash.hash_one(key)));
+  }
+};
+
+}  // namespace sfc::collections::hash
+
+namespace sfc::collections {
+using hash::IndexMap;
+}
@@ -0,0 +1,96 @@
+#include "sfc/collections/hash/interner.h"
+
+namespace sfc::collections::hash {
+
+// interned bytes are never freed before the interner, so they are bump allocated
+static auto copy_str(alloc::Arena& arena, Str s) -> Str {
+  const auto len = s.len();
+  if (len == 0) {
+    return {};
+  }
+
+  const auto dst = ptr::cast<char>(arena.allocate(mem::Layout::array<u8>(len)));
+  ptr::copy_nonoverlapping(s.as_ptr(), dst, len);
+  return Str{dst, len};
+}
+
+Interner::Interner() noexcept = default;
+
+Interner::~Interner() noexcept = default;
+
+Interner::Interner(Interner&& other) noexcept = default;
+
+Interner& Interner::operator=(Interner&& other) noexcept = default;
+
+auto Interner::len() const noexcept -> usize {
+  return _strs.len();
+}
+
+auto Interner::is_empty() const noexcept -> bool {
+  return _strs.is_empty();
+}
+
+void Interner::reserve(usize additional) {
+  _strs.reserve(additional);
+  _ids.reserve(additional);
+}
+
+auto Interner::intern(Str s) -> Symbol {
+  const auto id = _strs.len();
+  sfc::assert_(id < num::Int<u32>::MAX, "Interner::intern: too many symbols");
+
+  if (const auto old = _ids.find_or_insert(_strs.as_ptr(), s, u32(Hash::hash(s)), u32(id))) {
+    return Symbol{*old};
+  }
+  _strs.push(copy_str(_arena, s));
+  return Symbol{u32(id)};
+}
+
+auto Interner::get(Str s) const -> Option<Symbol> {
+  if (const auto id = _ids.find(_strs.as_ptr(), s, u32(Hash::hash(s)))) {
+    return Symbol{*id};
+  }
+  return {};
+}
+
+auto Interner::resolve(Symbol sym) const -> Str {
+  sfc::assert_(sym._id < _strs.len(), "Interner::resolve: unknown symbol");
+  return _strs[sym._id];
+}
+
+// arena chunks only, the id list and table are not counted
+auto Interner::allocated_bytes() const noexcept -> usize {
+  return _arena.allocated_bytes();
+}
+
+SyncInterner::SyncInterner() noexcept = default;
+
+SyncInterner::~SyncInterner() noexcept = default;
+
+auto SyncInterner::len() const -> usize {
+  auto guard = _lock.read();
+  return _inn.len();
+}
+
+auto SyncInterner::intern(Str s) -> Symbol {
+  {
+    auto guard = _lock.read();
+    if (auto sym = _inn.get(s)) {
+      return *sym;
+    }
+  }
+  auto guard = _lock.write();
+  return _inn.intern(s);
+}
+
+auto SyncInterner::get(Str s) const -> Option<Symbol> {
+  auto guard = _lock.read();
+  return _inn.get(s);
+}
+
+auto SyncInterner::resolve(Symbol sym) const -> Str {
+  auto guard = _lock.read();
+  return _inn.resolve(sym);
+}
+
+}  // namespace sfc::collections::hash
@@ -0,0 +1,94 @@
+#include "sfc/collections/hash/interner.h"
+#include "sfc/collections/hash/hash_map.h"
+#include "sfc/thread.h"
+#include "sfc/test/test.h"
+
+namespace sfc::collections::hash::test {
+
+SFC_TEST(interner_intern) {
+  auto strs = Interner{};
+  const auto a = strs.intern("alpha");
+  const auto b = strs.intern("beta");
+  sfc::assert_eq(a == b, false);
+  sfc::assert_eq(strs.intern(String::from("alpha")) == a, true);
+  sfc::assert_eq(strs.len(), 2U);
+
+  sfc::assert_eq(strs.resolve(a), "alpha");
+  sfc::assert_eq(strs.resolve(b), "beta");
+  sfc::assert_eq(strs.get("beta") == Option{b}, true);
+  sfc::assert_eq(strs.get("gamma").is_none(), true);
+
+  // the empty string is a symbol like any other
+  const auto e = strs.intern("");
+  sfc::assert_eq(strs.resolve(e), "");
+  sfc::assert_eq(strs.intern("") == e, true);
+}
+
+SFC_TEST(interner_many) {
+  auto strs = Interner{};
+  auto names = List<String>{};
+  for (auto i = 0U; i < 10000U; ++i) {
+    names.push(string::format("metric.{}.count", i % 5000));
+  }
+
+  const auto syms = strs.intern_all(names.iter());
+  sfc::assert_eq(syms.len(), 10000U);
+  sfc::assert_eq(strs.len(), 5000U);
+  for (auto i = 0U; i < 10000U; ++i) {
+    sfc::assert_eq(syms[i] == syms[i % 5000], true);
+    sfc::assert_eq(strs.resolve(syms[i]), names[i].as_str());
+  }
+
+  // a long string does not waste the current chunk
+  auto long_str = String{};
+  for (auto i = 0U; i < 1000U; ++i) {
+    long_str.push_str("0123456789");
+  }
+  sfc::assert_eq(strs.resolve(strs.intern(long_str)), long_str.as_str());
+}
+
+SFC_TEST(interner_symbol_key) {
+  auto strs = Interner{};
+  auto counts = HashMap<Symbol, u32>{};
+  const Str names[] = {"a", "b", "a", "c", "a"};
+  for (auto name : names) {
+    const auto sym = strs.intern(name);
+    if (auto cnt = counts.get_mut(sym)) {
+      *cnt += 1;
+    } else {
+      counts.insert(sym, 1);
+    }
+  }
+  sfc::assert_eq(counts.get(strs.intern("a")), Option{3U});
+  sfc::assert_eq(counts.get(strs.intern("c")), Option{1U});
+}
+
+SFC_TEST(sync_interner) {
+  static constexpr auto kNames = 1000U;
+
+  auto strs = SyncInterner{};
+  List<Symbol> syms[4];
+  auto worker = [&](u32 t) {
+    for (auto i = 0U; i < kNames; ++i) {
+      syms[t].push(strs.intern(string::format("name{}", i)));
+    }
+  };
+
+  {
+    auto t0 = thread::spawn_joined([&]() { worker(0); });
+    auto t1 = thread::spawn_joined([&]() { worker(1); });
+    auto t2 = thread::spawn_joined([&]() { worker(2); });
+    auto t3 = thread::spawn_joined([&]() { worker(3); });
+  }
+
+  sfc::assert_eq(strs.len(), usize{kNames});
+  for (auto i = 0U; i < kNames; ++i) {
+    const auto sym = syms[0][i];
+    sfc::assert_eq(strs.resolve(sym), string::format("name{}", i).as_str());
+    for (auto t = 1U; t < 4U; ++t) {
+      sfc::assert_eq(syms[t][i] == sym, true);
+    }
+  }
+}
+
+}  // namespace sfc::collections::hash::test
@@ -0,0 +1,98 @@
+#pragma once
+
+#include "sfc/alloc/arena.h"
+#include "sfc/alloc/list.h"
+#include "sfc/collections/hash/pos_tbl.h"
+#include "sfc/sync/rwlock.h"
+
+namespace sfc::collections::hash {
+
+// A compact id for a string owned by an `Interner`: equal strings give equal symbols.
+// Symbols from different interners must not be mixed.
+struct Symbol {
+  u32 _id = 0;
+
+ public:
+  auto id() const noexcept -> u32 {
+    return _id;
+  }
+
+  // trait: ops::Eq
+  auto operator==(const Symbol& other) const noexcept -> bool {
+    return _id == other._id;
+  }
+
+  // trait: ops::Ord
+  auto operator<(const Symbol& other) const noexcept -> bool {
+    return _id < other._id;
+  }
+
+  // trait: hash::Hash
+  void hash(auto& hasher) const noexcept {
+    hasher.write_u32(_id);
+  }
+
+  // trait: fmt::Display
+  void fmt(auto& f) const {
+    f.write_fmt("Symbol({})", _id);
+  }
+};
+
+// Maps strings to dense `Symbol` ids. Each distinct string is copied once into an arena,
+// so `resolve` hands out a `Str` that stays valid for the life of the interner.
+class Interner {
+  alloc::Arena _arena{};
+  List<Str> _strs{};
+  PosTbl<> _ids{};
+
+ public:
+  Interner() noexcept;
+  ~Interner() noexcept;
+  Interner(Interner&& other) noexcept;
+  Interner& operator=(Interner&& other) noexcept;
+
+  auto len() const noexcept -> usize;
+  auto is_empty() const noexcept -> bool;
+  void reserve(usize additional);
+
+  auto intern(Str s) -> Symbol;
+  auto get(Str s) const -> Option<Symbol>;
+  auto resolve(Symbol sym) const -> Str;
+  auto allocated_bytes() const noexcept -> usize;
+
+  // interns every string of `iter`, in order
+  auto intern_all(auto iter) -> List<Symbol> {
+    auto res = List<Symbol>{};
+    iter.for_each([&](const auto& s) { res.push(this->intern(Str{s})); });
+    return res;
+  }
+};
+
+// An `Interner` behind a reader/writer lock: lookups of known strings only take the read side.
+class SyncInterner {
+  mutable sync::RwLock _lock{};
+  Interner _inn{};
+
+ public:
+  SyncInterner() noexcept;
+  ~SyncInterner() noexcept;
+
+  auto len() const -> usize;
+  auto intern(Str s) -> Symbol;
+  auto get(Str s) const -> Option<Symbol>;
+  auto resolve(Symbol sym) const -> Str;
+
+  // takes the write lock once for the whole batch
+  auto intern_all(auto iter) -> List<Symbol> {
+    auto guard = _lock.write();
+    return _inn.intern_all(mem::move(iter));
+  }
+};
+
+}  // namespace sfc::collections::hash
+
+namespace sfc::collections {
+using hash::Interner;
+using hash::Symbol;
+using hash::SyncInterner;
+}  // namespace sfc::collections
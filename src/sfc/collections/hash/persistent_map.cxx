@@ -0,0 +1,145 @@
+#include "sfc/collections/hash/persistent_map.h"
+#include "sfc/alloc/string.h"
+#include "sfc/serde/json.h"
+#include "sfc/test/test.h"
+#include "sfc/thread.h"
+
+namespace sfc::collections::hash::test {
+
+// sends every key to one of four hashes, so most keys share a bucket below the last level
+struct FewHashes {
+  auto hash_one(const auto& key) const noexcept -> u64 {
+    return u64(key) % 4;
+  }
+};
+
+SFC_TEST(persistent_simple) {
+  auto m = PersistentMap<String, u32>{};
+  sfc::assert_eq(m.get(Str{"a"}), None{});
+  sfc::assert_eq(m.insert(String::from("a"), 1), None{});
+  sfc::assert_eq(m.insert(String::from("b"), 2), None{});
+  sfc::assert_eq(m.insert(String::from("a"), 3), Option{1U});
+  sfc::assert_eq(m.len(), 2U);
+  sfc::assert_eq(m.get(Str{"a"}), Option{3U});
+  sfc::assert_eq(m.contains_key(Str{"c"}), false);
+
+  sfc::assert_eq(m.remove(Str{"a"}), Option{3U});
+  sfc::assert_eq(m.remove(Str{"a"}), None{});
+  sfc::assert_eq(m.len(), 1U);
+
+  m.clear();
+  sfc::assert_eq(m.is_empty(), true);
+  sfc::assert_eq(m.iter().next().is_none(), true);
+}
+
+SFC_TEST(persistent_snapshot) {
+  auto m = PersistentMap<u32, String>{};
+  for (auto i = 0U; i < 1000U; ++i) {
+    m.insert(i, String::from("v0"));
+  }
+
+  const auto snap = m.clone();
+  sfc::assert_eq(snap.ptr_eq(m), true);
+
+  for (auto i = 0U; i < 1000U; i += 2) {
+    m.insert(i, String::from("v1"));
+  }
+  for (auto i = 1U; i < 1000U; i += 4) {
+    m.remove(i);
+  }
+  sfc::assert_eq(snap.ptr_eq(m), false);
+  sfc::assert_eq(m.len(), 750U);
+  sfc::assert_eq(snap.len(), 1000U);
+
+  for (auto i = 0U; i < 1000U; ++i) {
+    sfc::assert_eq(*snap.get(i), "v0");
+    if (i % 2 == 0) {
+      sfc::assert_eq(*m.get(i), "v1");
+    } else {
+      sfc::assert_eq(m.contains_key(i), i % 4 != 1);
+    }
+  }
+}
+
+SFC_TEST(persistent_collisions) {
+  auto m = PersistentMap<u32, u32, FewHashes>{};
+  for (auto i = 0U; i < 200U; ++i) {
+    m.insert(i, i * 10);
+  }
+  sfc::assert_eq(m.len(), 200U);
+
+  const auto snap = m.clone();
+  for (auto i = 0U; i < 200U; i += 3) {
+    sfc::assert_eq(m.remove(i), Option{i * 10});
+  }
+  for (auto i = 0U; i < 200U; ++i) {
+    sfc::assert_eq(m.get(i).is_some(), i % 3 != 0);
+    sfc::assert_eq(snap.get(i), Option{i * 10});
+  }
+
+  // emptying most of each bucket folds what is left back up the trie
+  for (auto i = 4U; i < 200U; i += 4) {
+    m.remove(i);
+  }
+  sfc::assert_eq(m.get(0U), None{});
+  sfc::assert_eq(m.get(4U), None{});
+  sfc::assert_eq(m.len(), 200U - 67U - 33U);
+}
+
+SFC_TEST(persistent_iter) {
+  auto m = PersistentMap<u32, u32>{};
+  auto sum = 0UL;
+  for (auto i = 0U; i < 5000U; ++i) {
+    m.insert(i, i);
+    sum += i;
+  }
+
+  auto cnt = 0UL;
+  m.iter().for_each([&](const auto& entry) {
+    sfc::assert_eq(entry._0, entry._1);
+    cnt += 1;
+    sum -= entry._1;
+  });
+  sfc::assert_eq(cnt, 5000U);
+  sfc::assert_eq(sum, 0U);
+}
+
+SFC_TEST(persistent_serde) {
+  auto m = PersistentMap<String, u32>{};
+  m.insert(String::from("x"), 1);
+  const auto s = serde::json::to_string(m);
+  sfc::assert_eq(s, R"({"x":1})");
+
+  auto des = serde::json::Deserializer{s};
+  const auto n = PersistentMap<String, u32>::deserialize(des).unwrap();
+  sfc::assert_eq(n.get(Str{"x"}), Option{1U});
+}
+
+SFC_TEST(persistent_threads) {
+  static constexpr auto kCount = 2000U;
+  auto m = PersistentMap<u32, u32>{};
+  for (auto i = 0U; i < kCount; ++i) {
+    m.insert(i, i);
+  }
+
+  // readers walk their snapshots while the writer rewrites every key
+  auto reader = [](const PersistentMap<u32, u32>& snap) {
+    for (auto n = 0U; n < 4U; ++n) {
+      for (auto i = 0U; i < kCount; ++i) {
+        sfc::assert_eq(snap.get(i), Option{i});
+      }
+    }
+  };
+  {
+    const auto s0 = m.clone();
+    const auto s1 = m.clone();
+    auto t0 = thread::spawn_joined([&]() { reader(s0); });
+    auto t1 = thread::spawn_joined([&]() { reader(s1); });
+    for (auto i = 0U; i < kCount; ++i) {
+      m.insert(i, i + 1);
+    }
+  }
+  sfc::assert_eq(m.get(0U), Option{1U});
+}
+
+}  // namespace sfc::collections::hash::test
@@ -0,0 +1,327 @@
+#pragma once
+
+#include "sfc/alloc/list.h"
+#include "sfc/sync/arc.h"
+
+namespace sfc::collections::hash {
+
+// An immutable-by-sharing hash map: a hash array mapped trie whose nodes are reference counted
+// with `Arc`. `clone` is O(1) and yields a snapshot that later updates never touch; an update
+// copies only the O(log32 n) nodes on its path that are shared, and changes the others in place.
+// Snapshots may be read and dropped on other threads while the owner keeps writing.
+// Keys with the same 64-bit hash end up together in a bucket at the bottom of the trie.
+template <class K, class V, class H = BuildHasher<>>
+class PersistentMap {
+  static constexpr u32 kBits = 5;
+  static constexpr u32 kMask = (1U << kBits) - 1;
+  static constexpr usize kMaxDepth = 64 / kBits + 2;
+
+  struct Entry {
+    u64 hash;
+    K key;
+    V val;
+  };
+
+  // Entries and children are kept apart and ordered by their bit, so the slot of a bit is the
+  // count of lower bits in its map. A node below the last level is a bucket of equal hashes,
+  // with both maps zero.
+  struct Node {
+    u32 datamap = 0;
+    u32 nodemap = 0;
+    List<Entry> entries{};
+    List<Arc<Node>> children{};
+  };
+
+  Arc<Node> _root{};
+  usize _len = 0;
+  [[no_unique_address]] H _hash{};
+
+ public:
+  // every entry, depth first
+  struct Iter : iter::Iterator<Tuple<const K&, const V&>> {
+    struct Frame {
+      const Node* node;
+      usize entry;
+      usize child;
+    };
+    Frame _stack[kMaxDepth];
+    usize _depth;
+
+   public:
+    auto next() noexcept -> Option<Tuple<const K&, const V&>> {
+      while (_depth != 0) {
+        auto& top = _stack[_depth - 1];
+        if (top.entry < top.node->entries.len()) {
+          const auto& e = top.node->entries[top.entry++];
+          return Tuple<const K&, const V&>{e.key, e.val};
+        }
+        if (top.child < top.node->children.len()) {
+          _stack[_depth++] = Frame{top.node->children[top.child++].as_ptr(), 0, 0};
+          continue;
+        }
+        _depth -= 1;
+      }
+      return {};
+    }
+  };
+
+  PersistentMap() noexcept = default;
+
+  explicit PersistentMap(H hash) noexcept : _hash{mem::move(hash)} {}
+
+  static auto with_hasher(H hash) -> PersistentMap {
+    return PersistentMap{mem::move(hash)};
+  }
+
+  auto len() const noexcept -> usize {
+    return _len;
+  }
+
+  auto is_empty() const noexcept -> bool {
+    return _len == 0;
+  }
+
+  // trait: Clone
+  // a snapshot, in O(1)
+  auto clone() const noexcept -> PersistentMap {
+    auto res = PersistentMap{_hash};
+    res._root = _root.clone();
+    res._len = _len;
+    return res;
+  }
+
+  // true if both maps are the same snapshot, which implies equal contents
+  auto ptr_eq(const PersistentMap& other) const noexcept -> bool {
+    return _root.as_ptr() == other._root.as_ptr();
+  }
+
+ public:
+  auto contains_key(const auto& key) const noexcept -> bool {
+    return this->find(_hash.hash_one(key), key) != nullptr;
+  }
+
+  auto get(const auto& key) const noexcept -> Option<const V&> {
+    if (const auto p = this->find(_hash.hash_one(key), key)) {
+      return p->val;
+    }
+    return {};
+  }
+
+  auto insert(K key, V val) -> Option<V> {
+    const auto hx = _hash.hash_one(key);
+    if (_root.as_ptr() == nullptr) {
+      _root = Arc<Node>::new_();
+    }
+    auto res = PersistentMap::insert_at(_root, 0, hx, key, val);
+    _len += res.is_none();
+    return res;
+  }
+
+  auto remove(const auto& key) -> Option<V> {
+    const auto hx = _hash.hash_one(key);
+    if (this->find(hx, key) == nullptr) {
+      return {};
+    }
+    auto res = PersistentMap::remove_at(_root, 0, hx, key);
+    _len -= 1;
+    if (_len == 0) {
+      _root = {};
+    }
+    return res;
+  }
+
+  void clear() {
+    _root = {};
+    _len = 0;
+  }
+
+  auto iter() const noexcept -> Iter {
+    auto res = Iter{};
+    if (const auto root = _root.as_ptr()) {
+      res._stack[res._depth++] = {root, 0, 0};
+    }
+    return res;
+  }
+
+ public:
+  // trait: fmt::Display
+  void fmt(auto& f) const {
+    auto imp = f.debug_map();
+    this->iter().for_each([&](const auto& entry) { imp.entry(entry._0, entry._1); });
+  }
+
+  // trait: serde::Serialize
+  void serialize(auto& ser) const {
+    auto imp = ser.serialize_obj();
+    this->iter().for_each([&](const auto& entry) { imp.serialize_entry(entry._0, entry._1); });
+  }
+
+  // trait: serde::Deserialize
+  template <class D>
+  static auto deserialize(D& des) {
+    auto visit = [&](auto& map) { return map.template collect<PersistentMap, K, V>(); };
+    return des.deserialize_obj(visit);
+  }
+
+ private:
+  static auto slot_of(u32 map, u32 bit) noexcept -> usize {
+    return usize(__builtin_popcount(map & (bit - 1)));
+  }
+
+  static auto dup(const auto& val) {
+    if constexpr (requires { val.clone(); }) {
+      return val.clone();
+    } else {
+      return val;
+    }
+  }
+
+  // the node behind `ref`, copied first if a snapshot shares it
+  static auto make_mut(Arc<Node>& ref) -> Node& {
+    if (auto p = ref.get_mut()) {
+      return *p;
+    }
+
+    const auto& old = *ref;
+    auto node = Node{old.datamap, old.nodemap};
+    node.entries = List<Entry>::with_capacity(old.entries.len() + 1);
+    for (const auto& e : old.entries.as_slice()) {
+      node.entries.push(Entry{e.hash, PersistentMap::dup(e.key), PersistentMap::dup(e.val)});
+    }
+    node.children = List<Arc<Node>>::with_capacity(old.children.len() + 1);
+    for (const auto& child : old.children.as_slice()) {
+      node.children.push(child.clone());
+    }
+    ref = Arc<Node>::new_(mem::move(node));
+    return *ref;
+  }
+
+  auto find(u64 hx, const auto& key) const noexcept -> const Entry* {
+    auto node = _root.as_ptr();
+    for (auto shift = 0U; node != nullptr; shift += kBits) {
+      if (shift >= 64) {
+        for (const auto& e : node->entries.as_slice()) {
+          if (e.key == key) {
+            return &e;
+          }
+        }
+        return nullptr;
+      }
+
+      const auto bit = 1U << ((hx >> shift) & kMask);
+      if (node->datamap & bit) {
+        const auto& e = node->entries[PersistentMap::slot_of(node->datamap, bit)];
+        return e.hash == hx && e.key == key ? &e : nullptr;
+      }
+      if (!(node->nodemap & bit)) {
+        return nullptr;
+      }
+      node = node->children[PersistentMap::slot_of(node->nodemap, bit)].as_ptr();
+    }
+    return nullptr;
+  }
+
+  // a node holding two entries that agree on all bits below `shift`
+  static auto make_pair(u32 shift, Entry a, Entry b) -> Arc<Node> {
+    auto node = Node{};
+    if (shift >= 64) {
+      node.entries.push(mem::move(a));
+      node.entries.push(mem::move(b));
+      return Arc<Node>::new_(mem::move(node));
+    }
+
+    const auto bit_a = 1U << ((a.hash >> shift) & kMask);
+    const auto bit_b = 1U << ((b.hash >> shift) & kMask);
+    if (bit_a == bit_b) {
+      node.nodemap = bit_a;
+      node.children.push(PersistentMap::make_pair(shift + kBits, mem::move(a), mem::move(b)));
+    } else {
+      node.datamap = bit_a | bit_b;
+      if (bit_b < bit_a) {
+        mem::swap(a, b);
+      }
+      node.entries.push(mem::move(a));
+      node.entries.push(mem::move(b));
+    }
+    return Arc<Node>::new_(mem::move(node));
+  }
+
+  static auto insert_at(Arc<Node>& ref, u32 shift, u64 hx, K& key, V& val) -> Option<V> {
+    auto& node = PersistentMap::make_mut(ref);
+    if (shift >= 64) {
+      for (auto& e : node.entries.as_mut_slice()) {
+        if (e.key == key) {
+          return mem::replace(e.val, mem::move(val));
+        }
+      }
+      node.entries.push(Entry{hx, mem::move(key), mem::move(val)});
+      return {};
+    }
+
+    const auto bit = 1U << ((hx >> shift) & kMask);
+    if (node.nodemap & bit) {
+      auto& child = node.children[PersistentMap::slot_of(node.nodemap, bit)];
+      return PersistentMap::insert_at(child, shift + kBits, hx, key, val);
+    }
+
+    if (node.datamap & bit) {
+      const auto idx = PersistentMap::slot_of(node.datamap, bit);
+      auto& e = node.entries[idx];
+      if (e.hash == hx && e.key == key) {
+        return mem::replace(e.val, mem::move(val));
+      }
+      // two entries in one slot: push both down a level
+      auto old = node.entries.remove(idx);
+      auto child = PersistentMap::make_pair(shift + kBits, mem::move(old), Entry{hx, mem::move(key), mem::move(val)});
+      node.datamap ^= bit;
+      node.nodemap |= bit;
+      node.children.insert(PersistentMap::slot_of(node.nodemap, bit), mem::move(child));
+      return {};
+    }
+
+    node.datamap |= bit;
+    node.entries.insert(PersistentMap::slot_of(node.datamap, bit), Entry{hx, mem::move(key), mem::move(val)});
+    return {};
+  }
+
+  // `key` must be in the trie
+  static auto remove_at(Arc<Node>& ref, u32 shift, u64 hx, const auto& key) -> Option<V> {
+    auto& node = PersistentMap::make_mut(ref);
+    if (shift >= 64) {
+      for (auto idx = 0UL; idx < node.entries.len(); ++idx) {
+        if (node.entries[idx].key == key) {
+          return node.entries.remove(idx).val;
+        }
+      }
+      return {};
+    }
+
+    const auto bit = 1U << ((hx >> shift) & kMask);
+    if (node.datamap & bit) {
+      const auto idx = PersistentMap::slot_of(node.datamap, bit);
+      node.datamap ^= bit;
+      return node.entries.remove(idx).val;
+    }
+
+    const auto cidx = PersistentMap::slot_of(node.nodemap, bit);
+    auto res = PersistentMap::remove_at(node.children[cidx], shift + kBits, hx, key);
+
+    // a child left with a single entry is folded back, so every trie of the same keys has the
+    // same shape and no chain of one-entry nodes survives a removal
+    auto& child = *node.children[cidx];
+    if (child.nodemap == 0 && child.entries.len() == 1) {
+      auto e = child.entries.pop().unwrap();
+      (void)node.children.remove(cidx);
+      node.nodemap ^= bit;
+      node.datamap |= bit;
+      node.entries.insert(PersistentMap::slot_of(node.datamap, bit), mem::move(e));
+    }
+    return res;
+  }
+};
+
+}  // namespace sfc::collections::hash
+
+namespace sfc::collections {
+using hash::PersistentMap;
+}  // namespace sfc::collections
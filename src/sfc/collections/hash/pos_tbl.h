@@ -0,0 +1,149 @@
+#pragma once
+
+#include "sfc/collections/hash/hash_tbl.h"
+
+namespace sfc::collections::hash {
+
+namespace detail {
+
+// the key of an item in a `PosTbl`'s array: the item itself, or its `key` field
+auto pos_key(const auto& item) noexcept -> const auto& {
+  if constexpr (requires { item.key; }) {
+    return item.key;
+  } else {
+    return item;
+  }
+}
+
+}  // namespace detail
+
+// Positions into an array kept by the owner, looked up by the keys of the items they point at.
+// Each position is tagged with the low half of its key's hash: the table rehashes from the tag
+// alone and never touches the items, and a key is compared only when the tags agree.
+// `items[idx]` is either the key itself or an entry with a `key` field.
+template <class A = alloc::Global>
+class PosTbl {
+  struct Pos {
+    u32 idx;
+    u32 tag;
+
+   public:
+    static auto spread(u32 tag) noexcept -> u64 {
+      return u64{tag} * 0x9E3779B97F4A7C15ULL;
+    }
+
+    void hash(auto& hasher) const noexcept {
+      hasher.write_u64(Pos::spread(tag));
+    }
+  };
+
+  struct Slot {
+    Pos key;
+  };
+
+  template <class N, class Q>
+  struct KeyEq {
+    const N* items;
+    const Q& key;
+    u32 tag;
+
+   public:
+    friend auto operator==(const Pos& pos, const KeyEq& eq) noexcept -> bool {
+      return pos.tag == eq.tag && detail::pos_key(eq.items[pos.idx]) == eq.key;
+    }
+  };
+
+  struct IdxEq {
+    u32 idx;
+
+   public:
+    friend auto operator==(const Pos& pos, const IdxEq& eq) noexcept -> bool {
+      return pos.idx == eq.idx;
+    }
+  };
+
+  HashTbl<Slot, BuildHasher<sfc::hash::IdentityHasher>, A> _tbl;
+
+ public:
+  PosTbl() noexcept = default;
+
+  explicit PosTbl(A alloc) noexcept : _tbl{{}, mem::move(alloc)} {}
+
+  static auto with_capacity(usize capacity, A alloc = {}) -> PosTbl {
+    auto res = PosTbl{mem::move(alloc)};
+    res.reserve(capacity);
+    return res;
+  }
+
+  auto len() const noexcept -> usize {
+    return _tbl.len();
+  }
+
+  auto cap() const noexcept -> usize {
+    return _tbl.cap();
+  }
+
+  auto allocated_bytes() const noexcept -> usize {
+    return _tbl.allocated_bytes();
+  }
+
+  void reserve(usize additional) {
+    _tbl.reserve(additional);
+  }
+
+  void clear() {
+    _tbl.clear();
+  }
+
+ public:
+  template <class N, class Q>
+  auto find(const N* items, const Q& key, u32 tag) const -> Option<u32> {
+    if (auto p = _tbl.search_hashed(Pos::spread(tag), KeyEq<N, Q>{items, key, tag})) {
+      return p->key.idx;
+    }
+    return {};
+  }
+
+  // the position of `key`, or none after `idx` was added as its position
+  template <class N, class Q>
+  auto find_or_insert(const N* items, const Q& key, u32 tag, u32 idx) -> Option<u32> {
+    const auto slot = _tbl.search_slot(Pos::spread(tag), KeyEq<N, Q>{items, key, tag});
+    if (slot.ptr) {
+      return slot.ptr->key.idx;
+    }
+    _tbl.insert_slot(slot, Slot{{idx, tag}});
+    return {};
+  }
+
+  template <class N, class Q>
+  auto remove(const N* items, const Q& key, u32 tag) -> Option<u32> {
+    const auto eq = KeyEq<N, Q>{items, key, tag};
+    return _tbl.remove_hashed(Pos::spread(tag), eq).map([](auto slot) { return slot.key.idx; });
+  }
+
+  // `idx` must not be in the table yet
+  void insert(u32 tag, u32 idx) {
+    const auto slot = _tbl.search_slot(Pos::spread(tag), IdxEq{idx});
+    _tbl.insert_slot(slot, Slot{{idx, tag}});
+  }
+
+  void erase(u32 tag, u32 idx) {
+    _tbl.remove_hashed(Pos::spread(tag), IdxEq{idx});
+  }
+
+  // the item moved from `from` to `to`
+  void relocate(u32 tag, u32 from, u32 to) {
+    _tbl.search_hashed(Pos::spread(tag), IdxEq{from})->key.idx = to;
+  }
+
+  // the items after `idx` moved down by one: a full scan
+  void shift_down(u32 idx) {
+    _tbl.iter_mut().for_each([&](Slot& slot) {
+      if (slot.key.idx > idx) {
+        slot.key.idx -= 1;
+      }
+    });
+  }
+};
+
+}  // namespace sfc::collections::hash
@@ -0,0 +1,133 @@
+#include "sfc/collections/hash/small_map.h"
+#include "sfc/serde/json.h"
+#include "sfc/test/test.h"
+
+namespace sfc::collections::hash::test {
+
+SFC_TEST(small_map_inline) {
+  auto m = SmallMap<u32, u32, 4>{};
+  for (auto i = 0U; i < 4U; ++i) {
+    sfc::assert_eq(m.insert(i, i * 10), None{});
+  }
+  sfc::assert_eq(m.is_inline(), true);
+  sfc::assert_eq(m.len(), 4U);
+  sfc::assert_eq(m.insert(2, 0), Option{20U});
+  sfc::assert_eq(m.get(2U), Option{0U});
+  sfc::assert_eq(m.get(4U), None{});
+
+  sfc::assert_eq(m.remove(0U), Option{0U});
+  sfc::assert_eq(m.remove(0U), None{});
+  sfc::assert_eq(m.get(3U), Option{30U});
+  sfc::assert_eq(m.len(), 3U);
+  sfc::assert_eq(m.is_inline(), true);
+}
+
+SFC_TEST(small_map_spill) {
+  auto m = SmallMap<u32, u32, 4>{};
+  for (auto i = 0U; i < 100U; ++i) {
+    m.insert(i, i);
+  }
+  sfc::assert_eq(m.is_inline(), false);
+  sfc::assert_eq(m.len(), 100U);
+  for (auto i = 0U; i < 100U; ++i) {
+    sfc::assert_eq(m.get(i), Option{i});
+  }
+
+  for (auto i = 3U; i < 100U; ++i) {
+    sfc::assert_eq(m.remove(i), Option{i});
+  }
+  // room kept for more than `N` entries stays in the table
+  m.shrink_to(10);
+  sfc::assert_eq(m.is_inline(), false);
+  sfc::assert_eq(m.get(2U), Option{2U});
+  m.shrink_to_fit();
+  sfc::assert_eq(m.is_inline(), true);
+  sfc::assert_eq(m.len(), 3U);
+
+  auto sum = 0U;
+  m.iter().for_each([&](const auto& entry) { sum += entry.val; });
+  sfc::assert_eq(sum, 0U + 1U + 2U);
+}
+
+SFC_TEST(small_map_str_key) {
+  auto m = SmallMap<String, u32, 2>{};
+  m.insert(String::from("a"), 1);
+  m.insert(String::from("b"), 2);
+  sfc::assert_eq(m.try_insert(String::from("a"), 9), Option{1U});
+  sfc::assert_eq(serde::json::to_string(m), R"({"a":1,"b":2})");
+
+  m.insert(String::from("c"), 3);
+  sfc::assert_eq(m.is_inline(), false);
+  sfc::assert_eq(m.get(Str{"a"}), Option{1U});
+  sfc::assert_eq(m.get(Str{"c"}), Option{3U});
+
+  auto n = mem::move(m);
+  sfc::assert_eq(n.len(), 3U);
+  sfc::assert_eq(n.get(Str{"b"}), Option{2U});
+}
+
+SFC_TEST(small_map_entry) {
+  auto m = SmallMap<u32, u32, 4>{};
+  for (auto i = 0U; i < 8U; ++i) {
+    m.entry(i % 3).and_modify([](u32& v) { v += 1; }).or_insert(1);
+  }
+  sfc::assert_eq(m.is_inline(), true);
+  sfc::assert_eq(m.get(0U), Option{3U});
+  sfc::assert_eq(m.get(2U), Option{2U});
+
+  auto e = m.entry(1);
+  sfc::assert_eq(e.is_occupied(), true);
+  sfc::assert_eq(e.occupied().remove(), 3U);
+  sfc::assert_eq(m.len(), 2U);
+
+  // a vacant entry on a full inline map spills it
+  m.entry(3).or_insert(30);
+  m.entry(4).or_insert(40);
+  sfc::assert_eq(m.entry(5).or_insert(50), 50U);
+  sfc::assert_eq(m.is_inline(), false);
+  sfc::assert_eq(m.len(), 5U);
+  sfc::assert_eq(m.entry(4).occupied().remove(), 40U);
+  sfc::assert_eq(m.entry(6).or_default(), 0U);
+  sfc::assert_eq(m.get(5U), Option{50U});
+  sfc::assert_eq(m.get(4U), None{});
+}
+
+SFC_TEST(small_map_raw_entry) {
+  auto a = SmallMap<u32, u32, 4>{};
+  auto b = SmallMap<u32, u32, 4>{};
+  for (auto i = 0U; i < 10U; ++i) {
+    const auto hx = a.hash_key(i);
+    a.raw_entry(hx, i).or_insert(i);
+    if (i < 3U) {
+      b.raw_entry(hx, i).or_insert(i * 2);
+    }
+  }
+  sfc::assert_eq(a.is_inline(), false);
+  sfc::assert_eq(b.is_inline(), true);
+  for (auto i = 0U; i < 3U; ++i) {
+    const auto hx = a.hash_key(i);
+    sfc::assert_eq(a.raw_get(hx, i), Option{i});
+    sfc::assert_eq(b.raw_get(hx, i), Option{i * 2});
+  }
+  sfc::assert_eq(b.raw_get(b.hash_key(9U), 9U), None{});
+
+  auto sum = 0U;
+  b.for_each([&](u32 key, u32 val) { sum += key + val; });
+  sfc::assert_eq(sum, 9U);
+}
+
+SFC_TEST(small_set) {
+  auto s = SmallSet<u32, 4>{};
+  sfc::assert_eq(s.insert(1), true);
+  sfc::assert_eq(s.insert(1), false);
+  sfc::assert_eq(s.contains(1U), true);
+  for (auto i = 0U; i < 10U; ++i) {
+    s.insert(i);
+  }
+  sfc::assert_eq(s.len(), 10U);
+  sfc::assert_eq(s.is_inline(), false);
+  sfc::assert_eq(s.remove(5U), true);
+  sfc::assert_eq(s.contains(5U), false);
+}
+
+}  // namespace sfc::collections::hash::test
@@ -0,0 +1,508 @@
+#pragma once
+
+#include "sfc/collections/hash/hash_tbl.h"
+
+namespace sfc::collections::hash {
+
+// the inline entries first, then the spilled table (only one of them is non-empty)
+template <class T>
+struct SmallIter : iter::Iterator<T&> {
+  slice::Iter<T> _inline;
+  hash::Iter<T> _spill;
+
+ public:
+  auto next() noexcept -> Option<T&> {
+    if (auto x = _inline.next()) {
+      return x;
+    }
+    return _spill.next();
+  }
+};
+
+// A map that keeps up to `N` entries inline and finds keys by a linear scan, with no heap allocation.
+// Inserting past `N` entries moves everything into a hash table; `shrink_to_fit` moves them back.
+// The API is `HashMap`'s: while inline, `raw_*` lookups ignore the hash and `stats` is empty.
+template <class K, class V, usize N = 8, class H = BuildHasher<>, class A = alloc::Global>
+class SmallMap {
+  static_assert(N > 0, "SmallMap: N must be positive");
+
+  struct Item {
+    K key;
+    V val;
+  };
+  using Tbl = HashTbl<Item, H, A>;
+
+  usize _len = 0;  // inline entries, zero while spilled
+  alignas(Item) u8 _inline[N * sizeof(Item)];
+  Tbl _tbl{};
+
+ public:
+  SmallMap() noexcept = default;
+
+  explicit SmallMap(H hash, A alloc = {}) noexcept : _tbl{mem::move(hash), mem::move(alloc)} {}
+
+  ~SmallMap() noexcept {
+    ptr::drop(this->inline_ptr(), _len);
+  }
+
+  SmallMap(SmallMap&& other) noexcept : _len{mem::take(other._len)}, _tbl{mem::move(other._tbl)} {
+    ptr::copy_nonoverlapping(other.inline_ptr(), this->inline_ptr(), _len);
+  }
+
+  SmallMap& operator=(SmallMap&& other) noexcept {
+    if (this == &other) return *this;
+    ptr::drop(this->inline_ptr(), _len);
+    _len = mem::take(other._len);
+    ptr::copy_nonoverlapping(other.inline_ptr(), this->inline_ptr(), _len);
+    _tbl = mem::move(other._tbl);
+    return *this;
+  }
+
+  static auto with_capacity(usize min_capacity, A alloc = {}) -> SmallMap {
+    auto res = SmallMap{H{}, mem::move(alloc)};
+    res.reserve(min_capacity);
+    return res;
+  }
+
+  static auto with_hasher(H hash, A alloc = {}) -> SmallMap {
+    return SmallMap{mem::move(hash), mem::move(alloc)};
+  }
+
+  auto len() const noexcept -> usize {
+    return _len + _tbl.len();
+  }
+
+  auto is_empty() const noexcept -> bool {
+    return this->len() == 0;
+  }
+
+  auto capacity() const noexcept -> usize {
+    return this->is_inline() ? N : _tbl.cap();
+  }
+
+  // whether the entries live in the inline storage
+  auto is_inline() const noexcept -> bool {
+    return _tbl.cap() == 0;
+  }
+
+  void reserve(usize additional) {
+    if (this->is_inline() && _len + additional <= N) {
+      return;
+    }
+    this->spill(additional);
+  }
+
+  // back to the inline storage once `min_len` entries fit there
+  void shrink_to(usize min_len) {
+    if (this->is_inline()) {
+      return;
+    }
+    if (cmp::max(_tbl.len(), min_len) > N) {
+      _tbl.shrink_to(min_len);
+      return;
+    }
+
+    _tbl.iter_mut().for_each([&](Item& entry) {
+      ptr::write(this->inline_ptr() + _len, mem::move(entry));
+      _len += 1;
+    });
+    _tbl.clear();
+    _tbl.shrink_to_fit();
+  }
+
+  void shrink_to_fit() {
+    this->shrink_to(0);
+  }
+
+  // of the spilled table; scans the whole table
+  auto stats() const -> TblStats {
+    return _tbl.stats();
+  }
+
+ public:
+  auto contains_key(const auto& key) const noexcept -> bool {
+    return this->search(key) != nullptr;
+  }
+
+  auto get(const auto& key) const noexcept -> Option<const V&> {
+    if (auto p = this->search(key)) {
+      return p->val;
+    }
+    return {};
+  }
+
+  auto get_mut(const auto& key) noexcept -> Option<V&> {
+    if (auto p = this->search(key)) {
+      return p->val;
+    }
+    return {};
+  }
+
+  // Returns the existing value, without inserting, when the key is present.
+  auto try_insert(K key, V val) noexcept -> Option<V&> {
+    if (auto p = this->search(key)) {
+      return p->val;
+    }
+    this->push_new(Item{mem::move(key), mem::move(val)});
+    return {};
+  }
+
+  auto insert(K key, V val) noexcept -> Option<V> {
+    if (!this->is_inline()) {
+      const auto slot = _tbl.search_slot(_tbl.hash_of(key), key);
+      if (slot.ptr) {
+        return mem::replace(slot.ptr->val, mem::move(val));
+      }
+      _tbl.insert_slot(slot, {mem::move(key), mem::move(val)});
+      return {};
+    }
+
+    if (auto p = this->search(key)) {
+      return mem::replace(p->val, mem::move(val));
+    }
+    this->push_new(Item{mem::move(key), mem::move(val)});
+    return {};
+  }
+
+  auto remove(const auto& key) -> Option<V> {
+    if (!this->is_inline()) {
+      return _tbl.remove(key).map([](auto entry) { return mem::move(entry.val); });
+    }
+
+    const auto p = this->search(key);
+    if (p == nullptr) {
+      return {};
+    }
+    auto entry = this->remove_inline(p);
+    return mem::move(entry.val);
+  }
+
+  void clear() {
+    ptr::drop(this->inline_ptr(), _len);
+    _len = 0;
+    _tbl.clear();
+  }
+
+ public:
+  class OccupiedEntry {
+    SmallMap* _map;
+    Item* _item;
+    usize _idx;  // the table slot, while spilled
+
+   public:
+    OccupiedEntry(SmallMap& map, Item& item, usize idx) noexcept : _map{&map}, _item{&item}, _idx{idx} {}
+
+    auto key() const noexcept -> const K& {
+      return _item->key;
+    }
+
+    auto get() const noexcept -> const V& {
+      return _item->val;
+    }
+
+    auto get_mut() noexcept -> V& {
+      return _item->val;
+    }
+
+    auto insert(V val) noexcept -> V {
+      return mem::replace(_item->val, mem::move(val));
+    }
+
+    auto remove() noexcept -> V {
+      if (_map->is_inline()) {
+        auto item = _map->remove_inline(_item);
+        return mem::move(item.val);
+      }
+      auto item = _map->_tbl.erase_slot(_idx);
+      return mem::move(item.val);
+    }
+  };
+
+  class VacantEntry {
+    SmallMap* _map;
+    typename Tbl::Slot _slot;  // where the key goes, while spilled
+    K _key;
+
+   public:
+    VacantEntry(SmallMap& map, const typename Tbl::Slot& slot, K key) noexcept
+        : _map{&map}, _slot{slot}, _key{mem::move(key)} {}
+
+    auto key() const noexcept -> const K& {
+      return _key;
+    }
+
+    // may spill the inline entries into the table
+    auto insert(V val) noexcept -> V& {
+      if (_map->is_inline()) {
+        return _map->push_new(Item{mem::move(_key), mem::move(val)}).val;
+      }
+      auto& item = _map->_tbl.insert_slot(_slot, {mem::move(_key), mem::move(val)});
+      return item.val;
+    }
+  };
+
+  // a view of one entry, found by a single search: occupied if the key is present
+  class Entry {
+    SmallMap* _map;
+    typename Tbl::Slot _slot;
+    K _key;
+
+   public:
+    Entry(SmallMap& map, const typename Tbl::Slot& slot, K key) noexcept
+        : _map{&map}, _slot{slot}, _key{mem::move(key)} {}
+
+    auto is_occupied() const noexcept -> bool {
+      return _slot.ptr != nullptr;
+    }
+
+    auto is_vacant() const noexcept -> bool {
+      return _slot.ptr == nullptr;
+    }
+
+    auto key() const noexcept -> const K& {
+      return _slot.ptr ? _slot.ptr->key : _key;
+    }
+
+    auto occupied() noexcept -> OccupiedEntry {
+      sfc::assert_(_slot.ptr != nullptr, "SmallMap::Entry::occupied: vacant entry");
+      return OccupiedEntry{*_map, *_slot.ptr, _slot.idx};
+    }
+
+    auto vacant() noexcept -> VacantEntry {
+      sfc::assert_(_slot.ptr == nullptr, "SmallMap::Entry::vacant: occupied entry");
+      return VacantEntry{*_map, _slot, mem::move(_key)};
+    }
+
+    auto or_insert(V val) noexcept -> V& {
+      if (_slot.ptr) {
+        return _slot.ptr->val;
+      }
+      return this->vacant().insert(mem::move(val));
+    }
+
+    auto or_insert_with(auto&& f) -> V& {
+      if (_slot.ptr) {
+        return _slot.ptr->val;
+      }
+      return this->vacant().insert(f());
+    }
+
+    auto or_default() noexcept -> V& {
+      return this->or_insert_with([] { return V{}; });
+    }
+
+    auto and_modify(auto&& f) -> Entry& {
+      if (_slot.ptr) {
+        f(_slot.ptr->val);
+      }
+      return *this;
+    }
+  };
+
+  auto entry(K key) noexcept -> Entry {
+    const auto hash = _tbl.hash_of(key);
+    return this->raw_entry(hash, mem::move(key));
+  }
+
+ public:
+  // hash a key once with `hash_key`, then reuse it against every map sharing the same hasher
+  auto hash_key(const auto& key) const noexcept -> u64 {
+    return _tbl.hash_of(key);
+  }
+
+  auto raw_get(u64 hash, const auto& key) const noexcept -> Option<const V&> {
+    if (auto p = this->search_hashed(hash, key)) {
+      return p->val;
+    }
+    return {};
+  }
+
+  auto raw_get_mut(u64 hash, const auto& key) noexcept -> Option<V&> {
+    if (auto p = this->search_hashed(hash, key)) {
+      return p->val;
+    }
+    return {};
+  }
+
+  auto raw_entry(u64 hash, K key) noexcept -> Entry {
+    if (!this->is_inline()) {
+      const auto slot = _tbl.search_slot(hash, key);
+      return Entry{*this, slot, mem::move(key)};
+    }
+    const auto p = this->search(key);
+    return Entry{*this, {p, 0, 0}, mem::move(key)};
+  }
+
+  // calls `f(key, val)` for every entry, the inline ones in insertion order
+  void for_each(auto&& f) const {
+    this->iter().for_each([&](const Item& entry) { f(entry.key, entry.val); });
+  }
+
+ public:
+  auto iter() const noexcept -> SmallIter<const Item> {
+    return {{}, {this->inline_ptr(), _len}, _tbl.iter()};
+  }
+
+  auto iter_mut() noexcept -> SmallIter<Item> {
+    return {{}, {this->inline_ptr(), _len}, _tbl.iter_mut()};
+  }
+
+ public:
+  // trait: fmt::Display
+  void fmt(auto& f) const {
+    auto imp = f.debug_map();
+    this->iter().for_each([&](const Item& entry) { imp.entry(entry.key, entry.val); });
+  }
+
+  // trait: serde::Serialize
+  void serialize(auto& ser) const {
+    auto imp = ser.serialize_obj();
+    this->iter().for_each([&](const Item& entry) { imp.serialize_entry(entry.key, entry.val); });
+  }
+
+  // trait: serde::Deserialize
+  template <class D>
+  static auto deserialize(D& des) {
+    auto visit = [&](auto& map) { return map.template collect<SmallMap, K, V>(); };
+    return des.deserialize_obj(visit);
+  }
+
+ private:
+  auto inline_ptr() const noexcept -> Item* {
+    return ptr::cast<Item>(ptr::cast_mut(_inline));
+  }
+
+  template <class Q>
+  auto search(const Q& key) const noexcept -> Item* {
+    if (!this->is_inline()) {
+      return _tbl.search(key);
+    }
+    const auto p = this->inline_ptr();
+    for (auto i = 0UL; i < _len; ++i) {
+      if (p[i].key == key) {
+        return &p[i];
+      }
+    }
+    return nullptr;
+  }
+
+  template <class Q>
+  auto search_hashed(u64 hash, const Q& key) const noexcept -> Item* {
+    if (!this->is_inline()) {
+      return _tbl.search_hashed(hash, key);
+    }
+    return this->search(key);
+  }
+
+  // the key is known to be absent
+  auto push_new(Item&& entry) -> Item& {
+    if (this->is_inline() && _len < N) {
+      const auto p = this->inline_ptr() + _len;
+      ptr::write(p, mem::move(entry));
+      _len += 1;
+      return *p;
+    }
+    this->reserve(1);
+    const auto slot = _tbl.search_slot(_tbl.hash_of(entry.key), entry.key);
+    return _tbl.insert_slot(slot, mem::move(entry));
+  }
+
+  // the last entry fills the hole
+  auto remove_inline(Item* p) -> Item {
+    auto entry = ptr::read(p);
+    const auto last = this->inline_ptr() + _len - 1;
+    if (p != last) {
+      ptr::copy_nonoverlapping(last, p, 1);
+    }
+    _len -= 1;
+    return entry;
+  }
+
+  void spill(usize additional) {
+    _tbl.reserve(_len + additional);
+    const auto p = this->inline_ptr();
+    for (auto i = 0UL; i < _len; ++i) {
+      _tbl.try_insert(ptr::read(p + i));
+    }
+    _len = 0;
+  }
+};
+
+// A set that keeps up to `N` values inline, see `SmallMap`.
+template <class T, usize N = 8, class H = BuildHasher<>, class A = alloc::Global>
+class SmallSet {
+  SmallMap<T, Unit, N, H, A> _inn{};
+
+ public:
+  SmallSet() noexcept = default;
+
+  auto len() const noexcept -> usize {
+    return _inn.len();
+  }
+
+  auto is_empty() const noexcept -> bool {
+    return _inn.is_empty();
+  }
+
+  auto capacity() const noexcept -> usize {
+    return _inn.capacity();
+  }
+
+  auto is_inline() const noexcept -> bool {
+    return _inn.is_inline();
+  }
+
+  void reserve(usize additional) {
+    _inn.reserve(additional);
+  }
+
+  void shrink_to_fit() {
+    _inn.shrink_to_fit();
+  }
+
+ public:
+  auto contains(const auto& val) const noexcept -> bool {
+    return _inn.contains_key(val);
+  }
+
+  // Returns whether the value was newly inserted.
+  auto insert(T val) noexcept -> bool {
+    return !_inn.try_insert(mem::move(val), {});
+  }
+
+  // Returns whether the value was present in the set.
+  auto remove(const auto& val) noexcept -> bool {
+    return bool(_inn.remove(val));
+  }
+
+  void clear() {
+    _inn.clear();
+  }
+
+ public:
+  // trait: fmt::Display
+  void fmt(auto& f) const {
+    auto imp = f.debug_set();
+    _inn.iter().for_each([&](const auto& entry) { imp.entry(entry.key); });
+  }
+
+  // trait: serde::Serialize
+  void serialize(auto& ser) const {
+    auto imp = ser.serialize_seq();
+    _inn.iter().for_each([&](const auto& entry) { imp.serialize_element(entry.key); });
+  }
+
+  // trait: serde::Deserialize
+  template <class D>
+  static auto deserialize(D& des) {
+    auto visit = [&](auto& seq) { return seq.template collect<SmallSet, T>(); };
+    return des.deserialize_seq(visit);
+  }
+};
+
+}  // namespace sfc::collections::hash
+
+namespace sfc::collections {
+using hash::SmallMap;
+using hash::SmallSet;
+}  // namespace sfc::collections
@@ -0,0 +1,45 @@
+#include "sfc/collections/hash/static_map.h"
+#include "sfc/test/test.h"
+
+namespace sfc::collections::hash::test {
+
+static constexpr auto kWords = static_map<Str, u32>({
+    {"alignas", 0},   {"alignof", 1},  {"auto", 2},       {"bool", 3},       {"break", 4},     {"case", 5},
+    {"catch", 6},     {"char", 7},     {"class", 8},      {"concept", 9},    {"const", 10},    {"consteval", 11},
+    {"constexpr", 12}, {"continue", 13}, {"decltype", 14}, {"default", 15},   {"delete", 16},   {"do", 17},
+    {"double", 18},   {"else", 19},    {"enum", 20},      {"explicit", 21},  {"export", 22},   {"extern", 23},
+    {"false", 24},    {"float", 25},   {"for", 26},       {"friend", 27},    {"goto", 28},     {"if", 29},
+    {"inline", 30},   {"int", 31},     {"long", 32},      {"mutable", 33},   {"namespace", 34}, {"new", 35},
+    {"noexcept", 36}, {"nullptr", 37}, {"operator", 38},  {"private", 39},   {"protected", 40}, {"public", 41},
+    {"requires", 42}, {"return", 43},  {"short", 44},     {"signed", 45},    {"sizeof", 46},   {"static", 47},
+    {"struct", 48},   {"switch", 49},  {"template", 50},  {"this", 51},      {"throw", 52},    {"true", 53},
+    {"try", 54},      {"typedef", 55}, {"typename", 56},  {"union", 57},     {"unsigned", 58}, {"using", 59},
+    {"virtual", 60},  {"void", 61},    {"volatile", 62},  {"while", 63},
+});
+
+// resolved during constant evaluation
+static_assert(kWords.contains_key(Str{"consteval"}));
+static_assert(!kWords.contains_key(Str{"constinit"}));
+
+SFC_TEST(static_map_str) {
+  sfc::assert_eq(kWords.len(), 64U);
+  for (auto i = 0U; i < kWords.len(); ++i) {
+    const auto key = kWords.keys()[i];
+    sfc::assert_eq(kWords.get(key), Option{kWords.vals()[i]});
+  }
+  sfc::assert_eq(kWords.get(Str{"while"}), Option{63U});
+  sfc::assert_eq(kWords.get(Str{"whilE"}), None{});
+  sfc::assert_eq(kWords.get(Str{""}), None{});
+
+  const auto name = String::from("template");
+  sfc::assert_eq(kWords.get(name), Option{50U});
+}
+
+SFC_TEST(static_map_int) {
+  static constexpr auto kPorts = static_map<u32, Str>({{80, "http"}, {443, "https"}, {22, "ssh"}});
+  sfc::assert_eq(kPorts.get(443U), Option{Str{"https"}});
+  sfc::assert_eq(kPorts.get(22U), Option{Str{"ssh"}});
+  sfc::assert_eq(kPorts.get(23U), None{});
+}
+
+}  // namespace sfc::collections::hash::test
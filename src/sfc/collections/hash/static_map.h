@@ -0,0 +1,232 @@
+#pragma once
+
+#include "sfc/core.h"
+
+namespace sfc::collections::hash {
+
+namespace detail {
+
+static constexpr u64 kStaticP0 = 0xa0761d6478bd642fULL;
+static constexpr u64 kStaticP1 = 0xe7037ed1a0b428dbULL;
+static constexpr u64 kStaticP2 = 0x8ebc6af09c88c6e3ULL;
+
+// the two halves of the 128-bit product, folded
+constexpr auto static_mix(u64 a, u64 b) noexcept -> u64 {
+#ifdef __SIZEOF_INT128__
+  const auto r = static_cast<unsigned __int128>(a) * b;
+  return u64(r) ^ u64(r >> 64);
+#else
+  const auto ha = a >> 32, la = a & 0xFFFFFFFFU;
+  const auto hb = b >> 32, lb = b & 0xFFFFFFFFU;
+  const auto rh = ha * hb, rm0 = ha * lb, rm1 = hb * la, rl = la * lb;
+  const auto t = rl + (rm0 << 32);
+  const auto lo = t + (rm1 << 32);
+  const auto hi = rh + (rm0 >> 32) + (rm1 >> 32) + u64(t < rl) + u64(lo < t);
+  return lo ^ hi;
+#endif
+}
+
+constexpr auto static_load(const char* p, usize n) noexcept -> u64 {
+  auto res = u64{0};
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+  if !consteval {
+    __builtin_memcpy(&res, p, n);
+    return res;
+  }
+#endif
+  for (auto i = 0UL; i < n; ++i) {
+    res |= u64(u8(p[i])) << (8 * i);
+  }
+  return res;
+}
+
+// a seeded hash with the same result at compile time and at run time
+constexpr auto static_hash(Str s, u64 seed) noexcept -> u64 {
+  const auto p = s.as_ptr();
+  const auto n = s.len();
+  auto h = seed ^ kStaticP0 ^ n;
+  auto i = 0UL;
+  for (; i + 8 <= n; i += 8) {
+    h = static_mix(h ^ detail::static_load(p + i, 8), kStaticP1);
+  }
+  return static_mix(h ^ detail::static_load(p + i, n - i), kStaticP2);
+}
+
+constexpr auto static_hash(u64 val, u64 seed) noexcept -> u64 {
+  return static_mix(val ^ seed ^ kStaticP0, kStaticP1);
+}
+
+}  // namespace detail
+
+template <class K, class V>
+struct StaticEntry {
+  K key;
+  V val;
+};
+
+// An immutable map over a fixed key set, built at compile time with a minimal perfect hash
+// (hash-and-displace). A lookup costs one hash, one displacement load and one key compare.
+// Keys are `Str` or integers; keys and values must be literal types.
+template <class K, class V, usize N>
+class StaticMap {
+  static_assert(N > 0 && N < num::Int<u32>::MAX, "StaticMap: N out of range");
+  static constexpr usize BUCKETS = (N + 3) / 4;
+
+  struct Disp {
+    u32 d1 = 0;
+    u32 d2 = 0;
+  };
+
+  u64 _seed = 0;
+  Disp _disps[BUCKETS] = {};
+  K _keys[N] = {};
+  V _vals[N] = {};
+
+ public:
+  consteval explicit StaticMap(const StaticEntry<K, V> (&items)[N]) {
+    for (auto i = 0UL; i < N; ++i) {
+      for (auto j = 0UL; j < i; ++j) {
+        if (items[i].key == items[j].key) {
+          panic::panic_fmt(fmt::Args{"StaticMap: duplicate key"});
+        }
+      }
+    }
+
+    for (auto seed = 0UL; seed < 1024; ++seed) {
+      if (this->try_build(items, seed)) {
+        return;
+      }
+    }
+    panic::panic_fmt(fmt::Args{"StaticMap: no perfect hash found"});
+  }
+
+  static constexpr auto len() noexcept -> usize {
+    return N;
+  }
+
+  constexpr auto contains_key(const auto& key) const noexcept -> bool {
+    return this->search(key) != N;
+  }
+
+  constexpr auto get(const auto& key) const noexcept -> Option<const V&> {
+    if (const auto idx = this->search(key); idx != N) {
+      return _vals[idx];
+    }
+    return {};
+  }
+
+  constexpr auto keys() const noexcept -> Slice<const K> {
+    return {_keys, N};
+  }
+
+  constexpr auto vals() const noexcept -> Slice<const V> {
+    return {_vals, N};
+  }
+
+ private:
+  struct Hashes {
+    usize g;
+    u64 f1;
+    u64 f2;
+  };
+
+  static constexpr auto hashes(const auto& key, u64 seed) noexcept -> Hashes {
+    u64 h;
+    if constexpr (trait::int_<K>) {
+      h = detail::static_hash(u64(key), seed);
+    } else {
+      h = detail::static_hash(Str{key}, seed);
+    }
+    return {usize((h >> 32) % BUCKETS), u32(h) % N, (h * detail::kStaticP2 >> 32) % N};
+  }
+
+  static constexpr auto slot(const Hashes& h, Disp d) noexcept -> usize {
+    return usize((h.f2 * d.d1 + h.f1 + d.d2) % N);
+  }
+
+  constexpr auto search(const auto& key) const noexcept -> usize {
+    const auto h = StaticMap::hashes(key, _seed);
+    const auto idx = StaticMap::slot(h, _disps[h.g]);
+    return _keys[idx] == key ? idx : N;
+  }
+
+  // place the largest buckets first, each at the first displacement whose slots are all free
+  consteval auto try_build(const StaticEntry<K, V> (&items)[N], u64 seed) -> bool {
+    Hashes hs[N] = {};
+    usize sizes[BUCKETS] = {};
+    for (auto i = 0UL; i < N; ++i) {
+      hs[i] = StaticMap::hashes(items[i].key, seed);
+      sizes[hs[i].g] += 1;
+    }
+
+    usize slot_of[N] = {};
+    bool used[N] = {};
+    for (auto size = N; size != 0; --size) {
+      for (auto g = 0UL; g < BUCKETS; ++g) {
+        if (sizes[g] != size) {
+          continue;
+        }
+        if (!StaticMap::place(hs, g, used, slot_of, _disps[g])) {
+          return false;
+        }
+      }
+    }
+
+    _seed = seed;
+    for (auto i = 0UL; i < N; ++i) {
+      _keys[slot_of[i]] = items[i].key;
+      _vals[slot_of[i]] = items[i].val;
+    }
+    return true;
+  }
+
+  static consteval auto place(const Hashes (&hs)[N], usize g, bool (&used)[N], usize (&slot_of)[N], Disp& disp)
+      -> bool {
+    usize members[N] = {};
+    auto cnt = 0UL;
+    for (auto i = 0UL; i < N; ++i) {
+      if (hs[i].g == g) {
+        members[cnt++] = i;
+      }
+    }
+
+    usize slots[N] = {};
+    for (auto d1 = 0U; d1 < N; ++d1) {
+      for (auto d2 = 0U; d2 < N; ++d2) {
+        const auto d = Disp{d1, d2};
+        auto ok = true;
+        for (auto k = 0UL; ok && k < cnt; ++k) {
+          slots[k] = StaticMap::slot(hs[members[k]], d);
+          ok = !used[slots[k]];
+          for (auto j = 0UL; ok && j < k; ++j) {
+            ok = slots[j] != slots[k];
+          }
+        }
+        if (!ok) {
+          continue;
+        }
+
+        for (auto k = 0UL; k < cnt; ++k) {
+          used[slots[k]] = true;
+          slot_of[members[k]] = slots[k];
+        }
+        disp = d;
+        return true;
+      }
+    }
+    return false;
+  }
+};
+
+// deduces `N` from the initializer: `static_map<Str, int>({{"a", 1}, {"b", 2}})`
+template <class K, class V, usize N>
+consteval auto static_map(const StaticEntry<K, V> (&items)[N]) -> StaticMap<K, V, N> {
+  return StaticMap<K, V, N>{items};
+}
+
+}  // namespace sfc::collections::hash
+
+namespace sfc::collections {
+using hash::StaticMap;
+using hash::static_map;
+}  // namespace sfc::collections
@@ -0,0 +1,163 @@
+#include "sfc/collections/radix_map.h"
+#include "sfc/serde/json.h"
+#include "sfc/test/test.h"
+
+namespace sfc::collections::radix::test {
+
+SFC_TEST(radix_simple) {
+  auto m = RadixMap<u32>{};
+  sfc::assert_eq(m.get("a"), None{});
+  sfc::assert_eq(m.insert("abc", 1), None{});
+  sfc::assert_eq(m.insert("abd", 2), None{});
+  sfc::assert_eq(m.insert("ab", 3), None{});
+  sfc::assert_eq(m.insert("", 4), None{});
+  sfc::assert_eq(m.insert("abc", 5), Option{1U});
+  sfc::assert_eq(m.len(), 4U);
+
+  sfc::assert_eq(m.get("abc"), Option{5U});
+  sfc::assert_eq(m.get("ab"), Option{3U});
+  sfc::assert_eq(m.get(""), Option{4U});
+  sfc::assert_eq(m.get("a"), None{});
+  sfc::assert_eq(m.get("abcd"), None{});
+
+  sfc::assert_eq(m.remove("ab"), Option{3U});
+  sfc::assert_eq(m.remove("ab"), None{});
+  sfc::assert_eq(m.remove(""), Option{4U});
+  sfc::assert_eq(m.get("abd"), Option{2U});
+  sfc::assert_eq(m.len(), 2U);
+
+  m.clear();
+  sfc::assert_eq(m.is_empty(), true);
+  sfc::assert_eq(m.iter().next().is_none(), true);
+}
+
+SFC_TEST(radix_long_prefix) {
+  // prefixes longer than a node stores, checked against the leaves
+  auto m = RadixMap<u32>{};
+  m.insert("/usr/local/share/doc/a", 1);
+  m.insert("/usr/local/share/doc/b", 2);
+  m.insert("/usr/local/share/man", 3);
+  m.insert("/usr/local/share/doc/", 4);
+  sfc::assert_eq(m.get("/usr/local/share/doc/a"), Option{1U});
+  sfc::assert_eq(m.get("/usr/local/share/man"), Option{3U});
+  sfc::assert_eq(m.get("/usr/local/share/doc/"), Option{4U});
+  sfc::assert_eq(m.get("/usr/local/SHARE/doc/a"), None{});
+  sfc::assert_eq(m.get("/usr/local/share/doc"), None{});
+
+  sfc::assert_eq(m.remove("/usr/local/share/man"), Option{3U});
+  sfc::assert_eq(m.remove("/usr/local/share/doc/"), Option{4U});
+  sfc::assert_eq(m.get("/usr/local/share/doc/b"), Option{2U});
+  sfc::assert_eq(m.get("/usr/local/share/doc/x"), None{});
+}
+
+SFC_TEST(radix_longest_prefix) {
+  auto m = RadixMap<u32>{};
+  m.insert("/", 1);
+  m.insert("/api", 2);
+  m.insert("/api/v1/", 3);
+  m.insert("/static/", 4);
+
+  const auto route = [&](Str path) -> u32 {
+    const auto res = m.longest_prefix(path);
+    return res ? (*res)._1 : 0;
+  };
+  sfc::assert_eq(route("/api/v1/users"), 3U);
+  sfc::assert_eq(route("/api/v2/users"), 2U);
+  sfc::assert_eq(route("/api"), 2U);
+  sfc::assert_eq(route("/static"), 1U);
+  sfc::assert_eq(route("/static/app.js"), 4U);
+  sfc::assert_eq(route("index.html"), 0U);
+  sfc::assert_eq((*m.longest_prefix("/apix"))._0, "/api");
+}
+
+SFC_TEST(radix_iter_prefix) {
+  auto m = RadixMap<u32>{};
+  const Str names[] = {"cpu.user", "cpu.sys", "cpu", "mem.free", "mem.used", "disk.io.read", "cpu.idle"};
+  for (auto i = 0U; i < sizeof(names) / sizeof(names[0]); ++i) {
+    m.insert(names[i], i);
+  }
+
+  auto keys = List<Str>{};
+  m.iter_prefix("cpu").for_each([&](const auto& entry) { keys.push(entry._0); });
+  sfc::assert_eq(keys.len(), 4U);
+  sfc::assert_eq(keys[0], "cpu");
+  sfc::assert_eq(keys[1], "cpu.idle");
+  sfc::assert_eq(keys[2], "cpu.sys");
+  sfc::assert_eq(keys[3], "cpu.user");
+
+  keys.clear();
+  m.iter_prefix("me").for_each([&](const auto& entry) { keys.push(entry._0); });
+  sfc::assert_eq(keys.len(), 2U);
+  sfc::assert_eq(keys[0], "mem.free");
+
+  sfc::assert_eq(m.iter_prefix("disk.io.r").next().is_some(), true);
+  sfc::assert_eq(m.iter_prefix("disk.io.w").next().is_none(), true);
+  sfc::assert_eq(m.iter_prefix("net").next().is_none(), true);
+  sfc::assert_eq(m.iter_prefix("").count(), m.len());
+}
+
+SFC_TEST(radix_grow_shrink) {
+  // every byte value under one node, so it passes through all four node sizes both ways
+  auto m = RadixMap<u32>{};
+  char buf[2] = {'k', 0};
+  for (auto i = 0U; i < 256U; ++i) {
+    buf[1] = char(i);
+    m.insert(Str{buf, 2}, i);
+  }
+  // a subtree under byte 1: once it is the only child, the node above is folded into it
+  m.insert("k\x01" "a", 1000);
+  m.insert("k\x01" "b", 1001);
+  sfc::assert_eq(m.len(), 258U);
+
+  const auto shrink_to = [&](auto keep, usize children) {
+    for (auto i = 0U; i < 256U; ++i) {
+      buf[1] = char(i);
+      if (!keep(i)) {
+        m.remove(Str{buf, 2});
+      }
+    }
+    for (auto i = 0U; i < 256U; ++i) {
+      buf[1] = char(i);
+      sfc::assert_eq(m.get(Str{buf, 2}), keep(i) ? Option{i} : None{});
+    }
+    sfc::assert_eq(m.get("k\x01" "a"), Option{1000U});
+    sfc::assert_eq(m.get("k\x01" "b"), Option{1001U});
+    sfc::assert_eq(m.len(), children + 2);
+
+    auto prev = Str{};
+    auto cnt = 0UL;
+    m.iter().for_each([&](const auto& entry) {
+      sfc::assert_lt(prev, entry._0);
+      prev = entry._0;
+      cnt += 1;
+    });
+    sfc::assert_eq(cnt, m.len());
+  };
+
+  // 53 children stay in a Node256, then down to Node48, Node16, Node4 and a single child
+  shrink_to([](u32 i) { return i % 5 == 0 || i == 1; }, 53);
+  shrink_to([](u32 i) { return i % 10 == 0 || i == 1; }, 27);
+  shrink_to([](u32 i) { return i % 40 == 0 || i == 1; }, 8);
+  shrink_to([](u32 i) { return i == 0 || i == 1 || i == 240; }, 3);
+  shrink_to([](u32 i) { return i == 1; }, 1);
+
+  sfc::assert_eq(m.remove("k\x01"), Option{1U});
+  sfc::assert_eq(m.remove("k\x01" "a"), Option{1000U});
+  sfc::assert_eq(m.get("k\x01" "b"), Option{1001U});
+  sfc::assert_eq(m.remove("k\x01" "b"), Option{1001U});
+  sfc::assert_eq(m.is_empty(), true);
+}
+
+SFC_TEST(radix_serde) {
+  auto m = RadixMap<u32>{};
+  m.insert("b", 2);
+  m.insert("a", 1);
+  const auto s = serde::json::to_string(m);
+  sfc::assert_eq(s, R"({"a":1,"b":2})");
+
+  auto des = serde::json::Deserializer{s};
+  const auto n = RadixMap<u32>::deserialize(des).unwrap();
+  sfc::assert_eq(n.get("b"), Option{2U});
+}
+
+}  // namespace sfc::collections::radix::test
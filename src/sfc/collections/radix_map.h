@@ -0,0 +1,821 @@
+#pragma once
+
+#include "sfc/alloc/string.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64)
+#include <emmintrin.h>
+#define SFC_RADIX_SSE2 1
+#endif
+
+namespace sfc::collections::radix {
+
+// An adaptive radix tree over byte-string keys, kept in byte order.
+// Inner nodes branch on one key byte and come in four sizes (4, 16, 48 and 256 children), grown
+// and shrunk as children come and go, so a sparse level costs a few bytes and a dense one is a
+// direct index. Runs of bytes with a single child are folded into the node below as a prefix.
+// Lookup cost depends on the key length, not on the number of keys, and keys sharing a prefix
+// share the nodes for it, which makes `longest_prefix` and `iter_prefix` single descents.
+template <class V>
+class RadixMap {
+  enum class Kind : u8 {
+    Leaf,
+    N4,
+    N16,
+    N48,
+    N256,
+  };
+
+  // prefix bytes kept in a node; longer prefixes are checked against a leaf below it
+  static constexpr usize kMaxPrefix = 10;
+
+  struct Node {
+    Kind kind;
+  };
+
+  struct Leaf : Node {
+    String key;
+    V val;
+  };
+
+  struct Inner : Node {
+    u16 num;
+    u32 prefix_len;
+    u8 prefix[kMaxPrefix];
+    Leaf* term;  // the key that ends right after the prefix
+  };
+
+  // children sorted by byte
+  struct Node4 : Inner {
+    static constexpr Kind kKind = Kind::N4;
+    u8 keys[4];
+    Node* children[4];
+  };
+
+  struct Node16 : Inner {
+    static constexpr Kind kKind = Kind::N16;
+    u8 keys[16];
+    Node* children[16];
+
+    // the slot of `b`, or 16: one compare of all keys at once where SSE2 is available
+    auto find(u8 b) const noexcept -> usize {
+#ifdef SFC_RADIX_SSE2
+      const auto keys = _mm_loadu_si128(reinterpret_cast<const __m128i*>(this->keys));
+      const auto cmp = _mm_cmpeq_epi8(keys, _mm_set1_epi8(char(b)));
+      const auto mask = u32(_mm_movemask_epi8(cmp)) & ((1U << this->num) - 1);
+      return mask != 0 ? usize(__builtin_ctz(mask)) : 16;
+#else
+      for (auto i = 0UL; i < this->num; ++i) {
+        if (this->keys[i] == b) {
+          return i;
+        }
+      }
+      return 16;
+#endif
+    }
+  };
+
+  // `index[b]` is one past the slot of the child for `b`, or zero
+  struct Node48 : Inner {
+    static constexpr Kind kKind = Kind::N48;
+    u8 index[256];
+    Node* children[48];
+  };
+
+  struct Node256 : Inner {
+    static constexpr Kind kKind = Kind::N256;
+    Node* children[256];
+  };
+
+  Node* _root = nullptr;
+  usize _len = 0;
+
+ public:
+  // the entries below a node in key order; a node's own key comes before its children
+  struct Iter : iter::Iterator<Tuple<Str, const V&>> {
+    struct Frame {
+      const Node* node;
+      u32 pos;  // zero before the node's own key, then one past the child cursor
+    };
+    List<Frame> _stack;
+
+   public:
+    auto next() noexcept -> Option<Tuple<Str, const V&>> {
+      while (!_stack.is_empty()) {
+        auto& top = _stack[_stack.len() - 1];
+        if (top.node->kind == Kind::Leaf) {
+          const auto leaf = static_cast<const Leaf*>(top.node);
+          (void)_stack.pop();
+          return Tuple<Str, const V&>{leaf->key.as_str(), leaf->val};
+        }
+
+        const auto inner = static_cast<const Inner*>(top.node);
+        if (top.pos == 0) {
+          top.pos = 1;
+          if (inner->term != nullptr) {
+            return Tuple<Str, const V&>{inner->term->key.as_str(), inner->term->val};
+          }
+        }
+        if (const auto child = RadixMap::child_at(inner, top.pos)) {
+          _stack.push(Frame{child, 0});
+        } else {
+          (void)_stack.pop();
+        }
+      }
+      return {};
+    }
+  };
+
+  RadixMap() noexcept = default;
+
+  ~RadixMap() noexcept {
+    this->clear();
+  }
+
+  RadixMap(RadixMap&& other) noexcept : _root{mem::take(other._root)}, _len{mem::take(other._len)} {}
+
+  RadixMap& operator=(RadixMap&& other) noexcept {
+    if (this == &other) return *this;
+    mem::swap(_root, other._root);
+    mem::swap(_len, other._len);
+    return *this;
+  }
+
+  auto len() const noexcept -> usize {
+    return _len;
+  }
+
+  auto is_empty() const noexcept -> bool {
+    return _len == 0;
+  }
+
+ public:
+  auto contains_key(Str key) const noexcept -> bool {
+    return this->find_leaf(key) != nullptr;
+  }
+
+  auto get(Str key) const noexcept -> Option<const V&> {
+    if (const auto leaf = this->find_leaf(key)) {
+      return leaf->val;
+    }
+    return {};
+  }
+
+  auto get_mut(Str key) noexcept -> Option<V&> {
+    if (const auto leaf = this->find_leaf(key)) {
+      return leaf->val;
+    }
+    return {};
+  }
+
+  // the entry with the longest key that is a prefix of `key`, e.g. the route for a path
+  auto longest_prefix(Str key) const noexcept -> Option<Tuple<Str, const V&>> {
+    auto best = static_cast<const Leaf*>(nullptr);
+    auto node = static_cast<const Node*>(_root);
+    for (auto depth = 0UL; node != nullptr; depth += 1) {
+      if (node->kind == Kind::Leaf) {
+        const auto leaf = static_cast<const Leaf*>(node);
+        if (RadixMap::has_prefix(key, leaf->key.as_str())) {
+          best = leaf;
+        }
+        break;
+      }
+
+      const auto inner = static_cast<const Inner*>(node);
+      if (RadixMap::prefix_mismatch(inner, key, depth) != inner->prefix_len) {
+        break;
+      }
+      depth += inner->prefix_len;
+      if (inner->term != nullptr) {
+        best = inner->term;
+      }
+      if (depth == key.len()) {
+        break;
+      }
+      const auto child = RadixMap::find_child(inner, RadixMap::byte_at(key, depth));
+      node = child ? *child : nullptr;
+    }
+
+    if (best == nullptr) {
+      return {};
+    }
+    return Tuple<Str, const V&>{best->key.as_str(), best->val};
+  }
+
+  auto insert(Str key, V val) -> Option<V> {
+    auto ref = &_root;
+    for (auto depth = 0UL;; depth += 1) {
+      const auto node = *ref;
+      if (node == nullptr) {
+        *ref = RadixMap::new_leaf(key, val);
+        _len += 1;
+        return {};
+      }
+
+      if (node->kind == Kind::Leaf) {
+        const auto leaf = static_cast<Leaf*>(node);
+        if (leaf->key == key) {
+          return mem::replace(leaf->val, mem::move(val));
+        }
+        *ref = RadixMap::split_leaf(leaf, RadixMap::new_leaf(key, val), depth);
+        _len += 1;
+        return {};
+      }
+
+      const auto inner = static_cast<Inner*>(node);
+      if (inner->prefix_len != 0) {
+        const auto pos = RadixMap::prefix_mismatch(inner, key, depth);
+        if (pos != inner->prefix_len) {
+          *ref = RadixMap::split_prefix(inner, depth, pos, RadixMap::new_leaf(key, val));
+          _len += 1;
+          return {};
+        }
+        depth += inner->prefix_len;
+      }
+
+      if (depth == key.len()) {
+        if (inner->term != nullptr) {
+          return mem::replace(inner->term->val, mem::move(val));
+        }
+        inner->term = RadixMap::new_leaf(key, val);
+        _len += 1;
+        return {};
+      }
+
+      const auto b = RadixMap::byte_at(key, depth);
+      if (const auto child = RadixMap::find_child(inner, b)) {
+        ref = child;
+        continue;
+      }
+      RadixMap::add_child(*ref, b, RadixMap::new_leaf(key, val));
+      _len += 1;
+      return {};
+    }
+  }
+
+  auto remove(Str key) -> Option<V> {
+    auto res = RadixMap::remove_at(_root, key, 0);
+    _len -= res.is_some();
+    return res;
+  }
+
+  void clear() {
+    if (_root != nullptr) {
+      RadixMap::drop_tree(mem::take(_root));
+    }
+    _len = 0;
+  }
+
+  auto iter() const noexcept -> Iter {
+    return RadixMap::iter_from(_root);
+  }
+
+  // the entries whose keys start with `prefix`, in key order
+  auto iter_prefix(Str prefix) const noexcept -> Iter {
+    auto node = static_cast<const Node*>(_root);
+    for (auto depth = 0UL; node != nullptr; depth += 1) {
+      if (node->kind == Kind::Leaf) {
+        const auto leaf = static_cast<const Leaf*>(node);
+        return RadixMap::has_prefix(leaf->key.as_str(), prefix) ? RadixMap::iter_from(node) : Iter{};
+      }
+      if (depth == prefix.len()) {
+        return RadixMap::iter_from(node);
+      }
+
+      const auto inner = static_cast<const Inner*>(node);
+      const auto pos = RadixMap::prefix_mismatch(inner, prefix, depth);
+      if (depth + pos == prefix.len()) {
+        return RadixMap::iter_from(node);
+      }
+      if (pos != inner->prefix_len) {
+        return {};
+      }
+      depth += inner->prefix_len;
+
+      const auto child = RadixMap::find_child(inner, RadixMap::byte_at(prefix, depth));
+      node = child ? *child : nullptr;
+    }
+    return {};
+  }
+
+ public:
+  // trait: fmt::Display
+  void fmt(auto& f) const {
+    auto imp = f.debug_map();
+    this->iter().for_each([&](const auto& entry) { imp.entry(entry._0, entry._1); });
+  }
+
+  // trait: serde::Serialize
+  void serialize(auto& ser) const {
+    auto imp = ser.serialize_obj();
+    this->iter().for_each([&](const auto& entry) { imp.serialize_entry(entry._0, entry._1); });
+  }
+
+  // trait: serde::Deserialize
+  template <class D>
+  static auto deserialize(D& des) {
+    auto visit = [&](auto& map) { return map.template collect<RadixMap, Str, V>(); };
+    return des.deserialize_obj(visit);
+  }
+
+ private:
+  static auto byte_at(Str s, usize idx) noexcept -> u8 {
+    return u8(s._ptr[idx]);
+  }
+
+  static auto has_prefix(Str s, Str prefix) noexcept -> bool {
+    return prefix.len() <= s.len() && Str{s._ptr, prefix.len()} == prefix;
+  }
+
+  static auto iter_from(const Node* node) -> Iter {
+    auto res = Iter{};
+    if (node != nullptr) {
+      res._stack.push({node, 0});
+    }
+    return res;
+  }
+
+  static auto new_leaf(Str key, V& val) -> Leaf* {
+    return new Leaf{{Kind::Leaf}, String::from(key), mem::move(val)};
+  }
+
+  template <class N>
+  static auto new_node(const Inner* like = nullptr) -> N* {
+    auto res = new N{};
+    res->kind = N::kKind;
+    if (like != nullptr) {
+      res->num = like->num;
+      res->prefix_len = like->prefix_len;
+      ptr::copy_nonoverlapping(like->prefix, res->prefix, kMaxPrefix);
+      res->term = like->term;
+    }
+    return res;
+  }
+
+  static void free_node(Node* node) {
+    switch (node->kind) {
+      case Kind::Leaf: delete static_cast<Leaf*>(node); break;
+      case Kind::N4:   delete static_cast<Node4*>(node); break;
+      case Kind::N16:  delete static_cast<Node16*>(node); break;
+      case Kind::N48:  delete static_cast<Node48*>(node); break;
+      case Kind::N256: delete static_cast<Node256*>(node); break;
+    }
+  }
+
+  static void drop_tree(Node* node) {
+    if (node->kind != Kind::Leaf) {
+      const auto inner = static_cast<Inner*>(node);
+      if (inner->term != nullptr) {
+        delete inner->term;
+      }
+      for (auto pos = 1U; auto child = RadixMap::child_at(inner, pos);) {
+        RadixMap::drop_tree(child);
+      }
+    }
+    RadixMap::free_node(node);
+  }
+
+  static auto take_leaf(Leaf* leaf) -> V {
+    auto res = mem::move(leaf->val);
+    delete leaf;
+    return res;
+  }
+
+  // any leaf below `node`, whose key holds the full prefix of every node on the way
+  static auto min_leaf(const Node* node) noexcept -> const Leaf* {
+    while (node->kind != Kind::Leaf) {
+      const auto inner = static_cast<const Inner*>(node);
+      if (inner->term != nullptr) {
+        return inner->term;
+      }
+      auto pos = 1U;
+      node = RadixMap::child_at(inner, pos);
+    }
+    return static_cast<const Leaf*>(node);
+  }
+
+  // how many bytes of the node's prefix match `key` from `depth`; short of `prefix_len` on a
+  // mismatch or when the key runs out
+  static auto prefix_mismatch(const Inner* node, Str key, usize depth) noexcept -> usize {
+    const auto max = cmp::min(usize{node->prefix_len}, key.len() - depth);
+    const auto stored = cmp::min(max, kMaxPrefix);
+    auto idx = 0UL;
+    for (; idx < stored; ++idx) {
+      if (node->prefix[idx] != RadixMap::byte_at(key, depth + idx)) {
+        return idx;
+      }
+    }
+    if (idx < max) {
+      const auto leaf = RadixMap::min_leaf(node)->key.as_str();
+      for (; idx < max; ++idx) {
+        if (RadixMap::byte_at(leaf, depth + idx) != RadixMap::byte_at(key, depth + idx)) {
+          return idx;
+        }
+      }
+    }
+    return idx;
+  }
+
+  // Only the stored prefix bytes are compared on the way down; the key of the leaf that is
+  // reached is compared in full, which catches a mismatch in the bytes that were skipped.
+  auto find_leaf(Str key) const noexcept -> Leaf* {
+    auto node = _root;
+    for (auto depth = 0UL; node != nullptr; depth += 1) {
+      if (node->kind == Kind::Leaf) {
+        const auto leaf = static_cast<Leaf*>(node);
+        return leaf->key == key ? leaf : nullptr;
+      }
+
+      const auto inner = static_cast<Inner*>(node);
+      if (inner->prefix_len != 0) {
+        if (key.len() - depth < inner->prefix_len) {
+          return nullptr;
+        }
+        const auto stored = cmp::min(usize{inner->prefix_len}, kMaxPrefix);
+        for (auto i = 0UL; i < stored; ++i) {
+          if (inner->prefix[i] != RadixMap::byte_at(key, depth + i)) {
+            return nullptr;
+          }
+        }
+        depth += inner->prefix_len;
+      }
+
+      if (depth == key.len()) {
+        const auto term = inner->term;
+        return term != nullptr && term->key == key ? term : nullptr;
+      }
+      const auto child = RadixMap::find_child(inner, RadixMap::byte_at(key, depth));
+      node = child ? *child : nullptr;
+    }
+    return nullptr;
+  }
+
+  static auto find_child(const Inner* node, u8 b) noexcept -> Node** {
+    switch (node->kind) {
+      case Kind::N4: {
+        const auto n = ptr::cast_mut(static_cast<const Node4*>(node));
+        for (auto i = 0UL; i < n->num; ++i) {
+          if (n->keys[i] == b) {
+            return &n->children[i];
+          }
+        }
+        return nullptr;
+      }
+      case Kind::N16: {
+        const auto n = ptr::cast_mut(static_cast<const Node16*>(node));
+        const auto idx = n->find(b);
+        return idx < n->num ? &n->children[idx] : nullptr;
+      }
+      case Kind::N48: {
+        const auto n = ptr::cast_mut(static_cast<const Node48*>(node));
+        const auto idx = n->index[b];
+        return idx != 0 ? &n->children[idx - 1] : nullptr;
+      }
+      case Kind::N256: {
+        const auto n = ptr::cast_mut(static_cast<const Node256*>(node));
+        return n->children[b] != nullptr ? &n->children[b] : nullptr;
+      }
+      default: return nullptr;
+    }
+  }
+
+  // the next child in byte order, advancing `pos` (one past the cursor) beyond it
+  static auto child_at(const Inner* node, u32& pos) noexcept -> Node* {
+    switch (node->kind) {
+      case Kind::N4:
+      case Kind::N16: {
+        const auto children = node->kind == Kind::N4 ? static_cast<const Node4*>(node)->children
+                                                     : static_cast<const Node16*>(node)->children;
+        return pos <= node->num ? children[pos++ - 1] : nullptr;
+      }
+      case Kind::N48: {
+        const auto n = static_cast<const Node48*>(node);
+        for (; pos <= 256; ++pos) {
+          if (const auto idx = n->index[pos - 1]) {
+            pos += 1;
+            return n->children[idx - 1];
+          }
+        }
+        return nullptr;
+      }
+      case Kind::N256: {
+        const auto n = static_cast<const Node256*>(node);
+        for (; pos <= 256; ++pos) {
+          if (const auto child = n->children[pos - 1]) {
+            pos += 1;
+            return child;
+          }
+        }
+        return nullptr;
+      }
+      default: return nullptr;
+    }
+  }
+
+  static void insert_sorted(u8* keys, Node** children, u16& num, u8 b, Node* child) noexcept {
+    auto idx = 0UL;
+    while (idx < num && keys[idx] < b) {
+      idx += 1;
+    }
+    ptr::copy(keys + idx, keys + idx + 1, num - idx);
+    ptr::copy(children + idx, children + idx + 1, num - idx);
+    keys[idx] = b;
+    children[idx] = child;
+    num += 1;
+  }
+
+  static void remove_sorted(u8* keys, Node** children, u16& num, u8 b) noexcept {
+    auto idx = 0UL;
+    while (keys[idx] != b) {
+      idx += 1;
+    }
+    ptr::copy(keys + idx + 1, keys + idx, num - idx - 1);
+    ptr::copy(children + idx + 1, children + idx, num - idx - 1);
+    num -= 1;
+  }
+
+  // a leaf, or a node with no children, goes where the key ends
+  static void place(Node4* node, Leaf* leaf, usize depth) noexcept {
+    const auto key = leaf->key.as_str();
+    if (key.len() == depth) {
+      node->term = leaf;
+      return;
+    }
+    RadixMap::insert_sorted(node->keys, node->children, node->num, RadixMap::byte_at(key, depth), leaf);
+  }
+
+  // a new node for two leaves that agree on their first `depth` bytes
+  static auto split_leaf(Leaf* old, Leaf* leaf, usize depth) -> Node* {
+    const auto a = old->key.as_str();
+    const auto b = leaf->key.as_str();
+    const auto max = cmp::min(a.len(), b.len()) - depth;
+    auto common = 0UL;
+    while (common < max && RadixMap::byte_at(a, depth + common) == RadixMap::byte_at(b, depth + common)) {
+      common += 1;
+    }
+
+    const auto node = RadixMap::new_node<Node4>();
+    node->prefix_len = u32(common);
+    ptr::copy_nonoverlapping(ptr::cast<const u8>(b._ptr + depth), node->prefix, cmp::min(common, kMaxPrefix));
+    RadixMap::place(node, old, depth + common);
+    RadixMap::place(node, leaf, depth + common);
+    return node;
+  }
+
+  // a new node for the first `pos` bytes of the prefix of `old`, above it and the new leaf
+  static auto split_prefix(Inner* old, usize depth, usize pos, Leaf* leaf) -> Node* {
+    const auto node = RadixMap::new_node<Node4>();
+    node->prefix_len = u32(pos);
+    ptr::copy_nonoverlapping(old->prefix, node->prefix, cmp::min(pos, kMaxPrefix));
+
+    // `old` keeps the bytes after the one it now hangs under
+    const auto rest = old->prefix_len - pos - 1;
+    auto edge = u8{0};
+    if (old->prefix_len <= kMaxPrefix) {
+      edge = old->prefix[pos];
+      ptr::copy(old->prefix + pos + 1, old->prefix, rest);
+    } else {
+      const auto key = RadixMap::min_leaf(old)->key.as_str();
+      edge = RadixMap::byte_at(key, depth + pos);
+      ptr::copy_nonoverlapping(ptr::cast<const u8>(key._ptr + depth + pos + 1), old->prefix, cmp::min(rest, kMaxPrefix));
+    }
+    old->prefix_len = u32(rest);
+
+    RadixMap::insert_sorted(node->keys, node->children, node->num, edge, old);
+    RadixMap::place(node, leaf, depth + pos);
+    return node;
+  }
+
+  // adds a child for `b`, which must be absent, moving to a wider node when this one is full
+  static void add_child(Node*& ref, u8 b, Node* child) {
+    const auto inner = static_cast<Inner*>(ref);
+    switch (inner->kind) {
+      case Kind::N4: {
+        const auto n = static_cast<Node4*>(inner);
+        if (n->num < 4) {
+          RadixMap::insert_sorted(n->keys, n->children, n->num, b, child);
+          return;
+        }
+        const auto m = RadixMap::new_node<Node16>(n);
+        ptr::copy_nonoverlapping(n->keys, m->keys, 4);
+        ptr::copy_nonoverlapping(n->children, m->children, 4);
+        RadixMap::insert_sorted(m->keys, m->children, m->num, b, child);
+        ref = m;
+        delete n;
+        return;
+      }
+      case Kind::N16: {
+        const auto n = static_cast<Node16*>(inner);
+        if (n->num < 16) {
+          RadixMap::insert_sorted(n->keys, n->children, n->num, b, child);
+          return;
+        }
+        const auto m = RadixMap::new_node<Node48>(n);
+        for (auto i = 0U; i < 16; ++i) {
+          m->index[n->keys[i]] = u8(i + 1);
+          m->children[i] = n->children[i];
+        }
+        m->index[b] = 17;
+        m->children[16] = child;
+        m->num += 1;
+        ref = m;
+        delete n;
+        return;
+      }
+      case Kind::N48: {
+        const auto n = static_cast<Node48*>(inner);
+        if (n->num < 48) {
+          auto slot = 0U;
+          while (n->children[slot] != nullptr) {
+            slot += 1;
+          }
+          n->index[b] = u8(slot + 1);
+          n->children[slot] = child;
+          n->num += 1;
+          return;
+        }
+        const auto m = RadixMap::new_node<Node256>(n);
+        for (auto i = 0U; i < 256; ++i) {
+          if (const auto idx = n->index[i]) {
+            m->children[i] = n->children[idx - 1];
+          }
+        }
+        m->children[b] = child;
+        m->num += 1;
+        ref = m;
+        delete n;
+        return;
+      }
+      case Kind::N256: {
+        const auto n = static_cast<Node256*>(inner);
+        n->children[b] = child;
+        n->num += 1;
+        return;
+      }
+      default: return;
+    }
+  }
+
+  static void remove_child(Inner* inner, u8 b) noexcept {
+    switch (inner->kind) {
+      case Kind::N4: {
+        const auto n = static_cast<Node4*>(inner);
+        RadixMap::remove_sorted(n->keys, n->children, n->num, b);
+        return;
+      }
+      case Kind::N16: {
+        const auto n = static_cast<Node16*>(inner);
+        RadixMap::remove_sorted(n->keys, n->children, n->num, b);
+        return;
+      }
+      case Kind::N48: {
+        const auto n = static_cast<Node48*>(inner);
+        n->children[n->index[b] - 1] = nullptr;
+        n->index[b] = 0;
+        n->num -= 1;
+        return;
+      }
+      case Kind::N256: {
+        const auto n = static_cast<Node256*>(inner);
+        n->children[b] = nullptr;
+        n->num -= 1;
+        return;
+      }
+      default: return;
+    }
+  }
+
+  // After a removal: moves to a narrower node below a threshold (lower than the one for growing,
+  // so a node at the boundary does not flip back and forth), and folds a node left with a single
+  // child and no key of its own into that child.
+  static void shrink(Node*& ref) {
+    const auto inner = static_cast<Inner*>(ref);
+    switch (inner->kind) {
+      case Kind::N4: {
+        const auto n = static_cast<Node4*>(inner);
+        if (n->num == 0) {
+          ref = n->term;
+          delete n;
+        } else if (n->num == 1 && n->term == nullptr) {
+          ref = RadixMap::merge_single(n);
+          delete n;
+        }
+        return;
+      }
+      case Kind::N16: {
+        const auto n = static_cast<Node16*>(inner);
+        if (n->num > 3) {
+          return;
+        }
+        const auto m = RadixMap::new_node<Node4>(n);
+        ptr::copy_nonoverlapping(n->keys, m->keys, n->num);
+        ptr::copy_nonoverlapping(n->children, m->children, n->num);
+        ref = m;
+        delete n;
+        return;
+      }
+      case Kind::N48: {
+        const auto n = static_cast<Node48*>(inner);
+        if (n->num > 12) {
+          return;
+        }
+        const auto m = RadixMap::new_node<Node16>(n);
+        m->num = 0;
+        for (auto i = 0U; i < 256; ++i) {
+          if (const auto idx = n->index[i]) {
+            m->keys[m->num] = u8(i);
+            m->children[m->num++] = n->children[idx - 1];
+          }
+        }
+        ref = m;
+        delete n;
+        return;
+      }
+      case Kind::N256: {
+        const auto n = static_cast<Node256*>(inner);
+        if (n->num > 37) {
+          return;
+        }
+        const auto m = RadixMap::new_node<Node48>(n);
+        m->num = 0;
+        for (auto i = 0U; i < 256; ++i) {
+          if (const auto child = n->children[i]) {
+            m->children[m->num++] = child;
+            m->index[i] = u8(m->num);
+          }
+        }
+        ref = m;
+        delete n;
+        return;
+      }
+      default: return;
+    }
+  }
+
+  // the only child of `node`, with the prefix of `node` and the edge byte prepended to its own
+  static auto merge_single(Node4* node) noexcept -> Node* {
+    const auto child = node->children[0];
+    if (child->kind == Kind::Leaf) {
+      return child;
+    }
+
+    const auto inner = static_cast<Inner*>(child);
+    u8 buf[kMaxPrefix];
+    auto len = cmp::min(usize{node->prefix_len}, kMaxPrefix);
+    ptr::copy_nonoverlapping(node->prefix, buf, len);
+    if (len < kMaxPrefix) {
+      buf[len++] = node->keys[0];
+    }
+    const auto tail = cmp::min(usize{inner->prefix_len}, kMaxPrefix - len);
+    ptr::copy_nonoverlapping(inner->prefix, buf + len, tail);
+    ptr::copy_nonoverlapping(buf, inner->prefix, len + tail);
+    inner->prefix_len += node->prefix_len + 1;
+    return inner;
+  }
+
+  static auto remove_at(Node*& ref, Str key, usize depth) -> Option<V> {
+    if (ref == nullptr) {
+      return {};
+    }
+    if (ref->kind == Kind::Leaf) {
+      const auto leaf = static_cast<Leaf*>(ref);
+      if (!(leaf->key == key)) {
+        return {};
+      }
+      ref = nullptr;
+      return RadixMap::take_leaf(leaf);
+    }
+
+    const auto inner = static_cast<Inner*>(ref);
+    if (RadixMap::prefix_mismatch(inner, key, depth) != inner->prefix_len) {
+      return {};
+    }
+    depth += inner->prefix_len;
+
+    if (depth == key.len()) {
+      if (inner->term == nullptr) {
+        return {};
+      }
+      auto res = RadixMap::take_leaf(mem::take(inner->term));
+      RadixMap::shrink(ref);
+      return res;
+    }
+
+    const auto b = RadixMap::byte_at(key, depth);
+    const auto child = RadixMap::find_child(inner, b);
+    if (child == nullptr) {
+      return {};
+    }
+    auto res = RadixMap::remove_at(*child, key, depth + 1);
+    if (res.is_some() && *child == nullptr) {
+      RadixMap::remove_child(inner, b);
+      RadixMap::shrink(ref);
+    }
+    return res;
+  }
+};
+
+}  // namespace sfc::collections::radix
+
+namespace sfc::collections {
+using radix::RadixMap;
+}  // namespace sfc::collections
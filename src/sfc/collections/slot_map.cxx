@@ -0,0 +1,82 @@
+#include "sfc/collections/slot_map.h"
+#include "sfc/alloc/string.h"
+#include "sfc/test/test.h"
+
+namespace sfc::collections::slot_map::test {
+
+SFC_TEST(slot_map_simple) {
+  auto m = SlotMap<String>{};
+  const auto a = m.insert(String::from("a"));
+  const auto b = m.insert(String::from("b"));
+  sfc::assert_eq(m.len(), 2U);
+  sfc::assert_eq(a == b, false);
+  sfc::assert_eq(m[a], "a");
+  sfc::assert_eq(m.get(b).is_some(), true);
+
+  m.get_mut(a)->push_str("x");
+  sfc::assert_eq(m[a], "ax");
+
+  sfc::assert_eq(m.remove(a).is_some(), true);
+  sfc::assert_eq(m.remove(a).is_none(), true);
+  sfc::assert_eq(m.contains_key(a), false);
+  sfc::assert_eq(m[b], "b");
+  sfc::assert_eq(m.contains_key(Key::null()), false);
+}
+
+SFC_TEST(slot_map_stale) {
+  auto m = SlotMap<u32>{};
+  const auto a = m.insert(1);
+  m.remove(a);
+
+  // the slot is reused, but under a new generation
+  const auto b = m.insert(2);
+  sfc::assert_eq(a._idx, b._idx);
+  sfc::assert_eq(m.get(a).is_none(), true);
+  sfc::assert_eq(m.get(b), Option{2U});
+  sfc::assert_eq(string::format("{}", b), "Key(0v3)");
+}
+
+SFC_TEST(slot_map_churn) {
+  auto m = SlotMap<u32>{};
+  auto keys = List<Key>{};
+  for (auto i = 0U; i < 1000U; ++i) {
+    keys.push(m.insert(i));
+  }
+  for (auto i = 0U; i < 1000U; i += 3) {
+    sfc::assert_eq(m.remove(keys[i]), Option{i});
+  }
+  for (auto i = 0U; i < 1000U; ++i) {
+    sfc::assert_eq(m.get(keys[i]).is_some(), i % 3 != 0);
+    if (i % 3 != 0) {
+      sfc::assert_eq(m[keys[i]], i);
+    }
+  }
+
+  auto cnt = 0UL;
+  m.iter().for_each([&](auto item) {
+    auto [key, val] = item;
+    sfc::assert_eq(keys[val] == key, true);
+    cnt += 1;
+  });
+  sfc::assert_eq(cnt, m.len());
+}
+
+SFC_TEST(slot_map_retain) {
+  auto m = SlotMap<u32>{};
+  for (auto i = 0U; i < 100U; ++i) {
+    m.insert_with([](Key key) { return key._idx; });
+  }
+  m.retain([](Key, u32& val) { return val % 2 == 0; });
+  sfc::assert_eq(m.len(), 50U);
+  m.iter().for_each([&](auto item) {
+    auto [key, val] = item;
+    sfc::assert_eq(key._idx, val);
+  });
+
+  m.clear();
+  sfc::assert_eq(m.is_empty(), true);
+  const auto k = m.insert(7);
+  sfc::assert_eq(m[k], 7U);
+}
+
+}  // namespace sfc::collections::slot_map::test
@@ -0,0 +1,248 @@
+#pragma once
+
+#include "sfc/alloc/list.h"
+
+namespace sfc::collections::slot_map {
+
+// A handle into a `SlotMap`: a slot index and the generation of the value it was issued for.
+// Once that value is removed the slot's generation moves on, so the key can never reach a
+// later value stored in the same slot.
+struct Key {
+  static constexpr u32 kNullIdx = num::Int<u32>::MAX;
+
+  u32 _idx = kNullIdx;
+  u32 _gen = 0;  // odd while the value is alive, never matched by the default key
+
+ public:
+  static auto null() noexcept -> Key {
+    return {};
+  }
+
+  auto is_null() const noexcept -> bool {
+    return _idx == kNullIdx;
+  }
+
+  // trait: ops::Eq
+  auto operator==(const Key& other) const noexcept -> bool {
+    return _idx == other._idx && _gen == other._gen;
+  }
+
+  // trait: hash::Hash
+  void hash(auto& hasher) const noexcept {
+    hasher.write_u64((u64{_gen} << 32) | _idx);
+  }
+
+  // trait: fmt::Display
+  void fmt(auto& f) const {
+    f.write_fmt("Key({}v{})", _idx, _gen);
+  }
+};
+
+// Values in one dense `List`, reached through a table of slots that hands out generational
+// `Key`s. Insert, remove and lookup are O(1), removal swaps the last value into the hole,
+// and keys stay valid however the values move. A key whose value was removed is detected,
+// not aliased to whatever reuses its slot.
+template <class T, class A = alloc::Global>
+class SlotMap {
+  static constexpr u32 kNil = num::Int<u32>::MAX;
+
+  struct Slot {
+    u32 gen;  // even when vacant
+    u32 pos;  // the value's position while occupied, the next free slot while vacant
+  };
+
+  List<T, A> _vals{};
+  List<u32, A> _owners{};  // the slot of each value
+  List<Slot, A> _slots{};
+  u32 _free = kNil;
+
+ public:
+  // the values in storage order, each with its key
+  template <class R>
+  struct Iter : iter::Iterator<Tuple<Key, R&>> {
+    R* _vals;
+    const u32* _owners;
+    const Slot* _slots;
+    usize _pos;
+    usize _len;
+
+   public:
+    auto next() noexcept -> Option<Tuple<Key, R&>> {
+      if (_pos == _len) {
+        return {};
+      }
+      const auto idx = _owners[_pos];
+      return Tuple<Key, R&>{Key{idx, _slots[idx].gen}, _vals[_pos++]};
+    }
+  };
+
+  SlotMap() noexcept = default;
+
+  static auto with_capacity(usize capacity, A alloc = {}) -> SlotMap {
+    auto res = SlotMap{};
+    res._vals = List<T, A>::with_capacity(capacity, alloc);
+    res._owners = List<u32, A>::with_capacity(capacity, alloc);
+    res._slots = List<Slot, A>::with_capacity(capacity, alloc);
+    return res;
+  }
+
+  auto len() const noexcept -> usize {
+    return _vals.len();
+  }
+
+  auto is_empty() const noexcept -> bool {
+    return _vals.is_empty();
+  }
+
+  auto capacity() const noexcept -> usize {
+    return _vals.capacity();
+  }
+
+  void reserve(usize additional) {
+    _vals.reserve(additional);
+    _owners.reserve(additional);
+    _slots.reserve(additional);
+  }
+
+  // the values in storage order, which changes on removal
+  auto values() const noexcept -> Slice<const T> {
+    return _vals.as_slice();
+  }
+
+  auto values_mut() noexcept -> Slice<T> {
+    return _vals.as_mut_slice();
+  }
+
+ public:
+  auto contains_key(Key key) const noexcept -> bool {
+    return this->pos_of(key) != kNil;
+  }
+
+  auto get(Key key) const noexcept -> Option<const T&> {
+    if (const auto pos = this->pos_of(key); pos != kNil) {
+      return _vals[pos];
+    }
+    return {};
+  }
+
+  auto get_mut(Key key) noexcept -> Option<T&> {
+    if (const auto pos = this->pos_of(key); pos != kNil) {
+      return _vals[pos];
+    }
+    return {};
+  }
+
+  auto operator[](Key key) const -> const T& {
+    const auto pos = this->pos_of(key);
+    sfc::assert_(pos != kNil, "SlotMap::operator[]: stale or foreign key");
+    return _vals[pos];
+  }
+
+  auto operator[](Key key) -> T& {
+    const auto pos = this->pos_of(key);
+    sfc::assert_(pos != kNil, "SlotMap::operator[]: stale or foreign key");
+    return _vals[pos];
+  }
+
+  auto insert(T val) -> Key {
+    return this->insert_with([&](Key) { return mem::move(val); });
+  }
+
+  // `f` gets the key of the new value, for values that refer to themselves
+  auto insert_with(auto&& f) -> Key {
+    const auto pos = u32(_vals.len());
+    sfc::assert_(pos < kNil, "SlotMap::insert: too many values");
+
+    auto key = Key{_free, 0};
+    if (_free != kNil) {
+      auto& slot = _slots[_free];
+      key._gen = slot.gen + 1;
+      _free = slot.pos;
+    } else {
+      key = Key{u32(_slots.len()), 1};
+      _slots.push(Slot{0, 0});
+    }
+
+    _vals.push(f(key));
+    _owners.push(key._idx);
+    _slots[key._idx] = Slot{key._gen, pos};
+    return key;
+  }
+
+  auto remove(Key key) -> Option<T> {
+    const auto pos = this->pos_of(key);
+    if (pos == kNil) {
+      return {};
+    }
+
+    const auto last = _vals.len() - 1;
+    if (pos != last) {
+      _slots[_owners[last]].pos = pos;
+    }
+    _owners.swap_remove(pos);
+    this->release(key._idx);
+    return _vals.swap_remove(pos);
+  }
+
+  // keeps the values for which `f(key, val)` is true
+  void retain(auto&& f) {
+    for (auto pos = 0UL; pos < _vals.len();) {
+      const auto idx = _owners[pos];
+      if (f(Key{idx, _slots[idx].gen}, _vals[pos])) {
+        pos += 1;
+        continue;
+      }
+      this->remove(Key{idx, _slots[idx].gen});
+    }
+  }
+
+  void clear() {
+    for (auto idx : _owners.as_slice()) {
+      this->release(idx);
+    }
+    _owners.clear();
+    _vals.clear();
+  }
+
+ public:
+  auto iter() const noexcept -> Iter<const T> {
+    return {{}, _vals.as_ptr(), _owners.as_ptr(), _slots.as_ptr(), 0, _vals.len()};
+  }
+
+  auto iter_mut() noexcept -> Iter<T> {
+    return {{}, _vals.as_mut_ptr(), _owners.as_ptr(), _slots.as_ptr(), 0, _vals.len()};
+  }
+
+  // trait: fmt::Display
+  void fmt(auto& f) const {
+    auto imp = f.debug_list();
+    _vals.iter().for_each([&](const T& val) { imp.entry(val); });
+  }
+
+ private:
+  auto pos_of(Key key) const noexcept -> u32 {
+    if (key._idx >= _slots.len()) {
+      return kNil;
+    }
+    const auto& slot = _slots[key._idx];
+    return slot.gen == key._gen && (slot.gen & 1) ? slot.pos : kNil;
+  }
+
+  // a slot whose generation would wrap is retired, so no old key can ever match it again
+  void release(u32 idx) {
+    auto& slot = _slots[idx];
+    slot.gen += 1;
+    if (slot.gen == 0) {
+      return;
+    }
+    slot.pos = _free;
+    _free = idx;
+  }
+};
+
+}  // namespace sfc::collections::slot_map
+
+namespace sfc::collections {
+using slot_map::SlotMap;
+using SlotKey = slot_map::Key;
+}  // namespace sfc::collections
@@ -14,4 +14,26 @@ auto (max)(T a, T b) -> T {
   return a > b ? a : b;
 }
 
+// Orders `T` backwards, e.g. to turn a max-heap into a min-heap.
+template <class T>
+struct Reverse {
+  T _0;
+
+ public:
+  // trait: ops::Eq
+  auto operator==(const Reverse& other) const -> bool {
+    return _0 == other._0;
+  }
+
+  // trait: ops::Ord
+  auto operator<(const Reverse& other) const -> bool {
+    return other._0 < _0;
+  }
+
+  // trait: fmt::Display
+  void fmt(auto& f) const {
+    f.write_fmt("Reverse({})", _0);
+  }
+};
+
 }  // namespace sfc::cmp
@@ -30,4 +30,136 @@ void FNVHasher::write_u64(u64 val) noexcept {
   this->write(mem::as_bytes(val));
 }
 
+// 64x64 -> 128 bit multiply, returns {lo, hi}
+static inline void wy_mum(u64& a, u64& b) noexcept {
+#ifdef __SIZEOF_INT128__
+  const auto r = static_cast<unsigned __int128>(a) * b;
+  a = static_cast<u64>(r);
+  b = static_cast<u64>(r >> 64);
+#else
+  const auto ha = a >> 32, la = a & 0xFFFFFFFFU;
+  const auto hb = b >> 32, lb = b & 0xFFFFFFFFU;
+  const auto rh = ha * hb, rm0 = ha * lb, rm1 = hb * la, rl = la * lb;
+  const auto t = rl + (rm0 << 32);
+  const auto lo = t + (rm1 << 32);
+  const auto hi = rh + (rm0 >> 32) + (rm1 >> 32) + u64(t < rl) + u64(lo < t);
+  a = lo;
+  b = hi;
+#endif
+}
+
+static inline auto wy_mix(u64 a, u64 b) noexcept -> u64 {
+  wy_mum(a, b);
+  return a ^ b;
+}
+
+static inline auto wy_r8(const u8* p) noexcept -> u64 {
+  auto v = u64{0};
+  __builtin_memcpy(&v, p, 8);
+  return v;
+}
+
+static inline auto wy_r4(const u8* p) noexcept -> u64 {
+  auto v = u32{0};
+  __builtin_memcpy(&v, p, 4);
+  return v;
+}
+
+static inline auto wy_r3(const u8* p, usize k) noexcept -> u64 {
+  return (u64{p[0]} << 16) | (u64{p[k >> 1]} << 8) | p[k - 1];
+}
+
+auto WyHasher::finish() const noexcept -> u64 {
+  return _state;
+}
+
+void WyHasher::write(slice::Slice<const u8> bytes) noexcept {
+  const auto len = bytes._len;
+  auto p = bytes._ptr;
+  auto seed = _state ^ wy_mix(_state ^ P0, P1);
+  auto a = u64{0};
+  auto b = u64{0};
+
+  if (len <= 16) {
+    if (len >= 4) {
+      const auto k = (len >> 3) << 2;
+      a = (wy_r4(p) << 32) | wy_r4(p + k);
+      b = (wy_r4(p + len - 4) << 32) | wy_r4(p + len - 4 - k);
+    } else if (len > 0) {
+      a = wy_r3(p, len);
+    }
+  } else {
+    auto i = len;
+    if (i >= 48) {
+      auto see1 = seed;
+      auto see2 = seed;
+      do {
+        seed = wy_mix(wy_r8(p) ^ P1, wy_r8(p + 8) ^ seed);
+        see1 = wy_mix(wy_r8(p + 16) ^ P2, wy_r8(p + 24) ^ see1);
+        see2 = wy_mix(wy_r8(p + 32) ^ P3, wy_r8(p + 40) ^ see2);
+        p += 48;
+        i -= 48;
+      } while (i >= 48);
+      seed ^= see1 ^ see2;
+    }
+    while (i > 16) {
+      seed = wy_mix(wy_r8(p) ^ P1, wy_r8(p + 8) ^ seed);
+      p += 16;
+      i -= 16;
+    }
+    a = wy_r8(p + i - 16);
+    b = wy_r8(p + i - 8);
+  }
+
+  a ^= P1;
+  b ^= seed;
+  wy_mum(a, b);
+  _state = wy_mix(a ^ P0 ^ len, b ^ P1);
+}
+
+void WyHasher::write_u8(u8 val) noexcept {
+  this->write_u64(val);
+}
+
+void WyHasher::write_u16(u16 val) noexcept {
+  this->write_u64(val);
+}
+
+void WyHasher::write_u32(u32 val) noexcept {
+  this->write_u64(val);
+}
+
+void WyHasher::write_u64(u64 val) noexcept {
+  auto a = _state ^ P0;
+  auto b = val ^ P1;
+  wy_mum(a, b);
+  _state = wy_mix(a ^ P0, b ^ P1);
+}
+
+auto IdentityHasher::finish() const noexcept -> u64 {
+  return _state;
+}
+
+void IdentityHasher::write(slice::Slice<const u8> bytes) noexcept {
+  for (auto byte : bytes) {
+    _state = (_state << 8) | byte;
+  }
+}
+
+void IdentityHasher::write_u8(u8 val) noexcept {
+  _state = val;
+}
+
+void IdentityHasher::write_u16(u16 val) noexcept {
+  _state = val;
+}
+
+void IdentityHasher::write_u32(u32 val) noexcept {
+  _state = val;
+}
+
+void IdentityHasher::write_u64(u64 val) noexcept {
+  _state = val;
+}
+
 }  // namespace sfc::hash
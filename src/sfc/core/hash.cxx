@@ -0,0 +1,68 @@
+#include "sfc/test/test.h"
+#include "sfc/core/hash.h"
+
+namespace sfc::hash::test {
+
+static auto fnv_of(Str s) -> u64 {
+  auto h = FNVHasher{};
+  h.write(s.as_bytes());
+  return h.finish();
+}
+
+static auto fnv_of(Slice<const u8> bytes) -> u64 {
+  auto h = FNVHasher{};
+  h.write(bytes);
+  return h.finish();
+}
+
+static auto wy_of(Str s) -> u64 {
+  auto h = WyHasher{};
+  h.write(s.as_bytes());
+  return h.finish();
+}
+
+SFC_TEST(fnv_stable) {
+  sfc::assert_eq(fnv_of(""), 0xcbf29ce484222325ULL);
+  sfc::assert_eq(fnv_of("a"), 0xaf63dc4c8601ec8cULL);
+}
+
+SFC_TEST(fnv_int) {
+  // integers hash as their native bytes, as they did before `Hash::write`
+  const auto x = 0x01020304U;
+  sfc::assert_eq(Hash::hash<u32, FNVHasher>(x), fnv_of(mem::as_bytes(x)));
+  sfc::assert_eq(Hash::hash<u16, FNVHasher>(u16{0x0102}), fnv_of(mem::as_bytes(u16{0x0102})));
+  sfc::assert_eq(Hash::hash<u8, FNVHasher>(u8{7}), fnv_of(mem::as_bytes(u8{7})));
+  sfc::assert_eq(Hash::hash<i32, FNVHasher>(-1), 0x994f76653e2a3951ULL);
+}
+
+SFC_TEST(wy_bytes) {
+  const Str keys[] = {"", "a", "ab", "abcd", "0123456789abcdef", "0123456789abcdefg",
+                      "the quick brown fox jumps over the lazy dog, the quick brown fox"};
+  // fixed values: each length class of `write` is pinned
+  const u64 expect[] = {0x93228a4de0eec5a2ULL, 0xaced12527fe5bff8ULL, 0xe9c28c2968258c7dULL, 0x6d9a9834037410ebULL,
+                        0x88de385a856cfb95ULL, 0x14f37288a5f8073aULL, 0x7aba258fa84bccbaULL};
+  for (auto i = 0U; i < 7; ++i) {
+    sfc::assert_eq(wy_of(keys[i]), expect[i]);
+    for (auto j = i + 1; j < 7; ++j) {
+      sfc::assert_ne(wy_of(keys[i]), wy_of(keys[j]));
+    }
+  }
+  sfc::assert_eq(Str{"hello"}.hash(), wy_of("hello"));
+}
+
+SFC_TEST(wy_int) {
+  sfc::assert_eq(Hash::hash(42U), Hash::hash(42UL));
+  sfc::assert_ne(Hash::hash(1), Hash::hash(2));
+
+  // sequential keys must spread over both the low (slot) and high (tag) bits
+  auto low = 0UL;
+  auto high = 0UL;
+  for (auto i = 0UL; i < 64; ++i) {
+    low |= 1UL << (Hash::hash(i) & 63);
+    high |= 1UL << (Hash::hash(i) >> 58);
+  }
+  sfc::assert_gt(__builtin_popcountll(low), 32);
+  sfc::assert_gt(__builtin_popcountll(high), 32);
+}
+
+}  // namespace sfc::hash::test
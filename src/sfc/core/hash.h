@@ -5,6 +5,7 @@
 
 namespace sfc::hash {
 
+// byte-wise FNV-1a, the output is stable across versions and platforms (on-disk hashes)
 struct FNVHasher {
   static constexpr u64 OFFSET = 0xcbf29ce484222325ULL;
   static constexpr u64 PRIME = 0x100000001b3ULL;
@@ -20,26 +21,88 @@ struct FNVHasher {
   void write_u64(u64 val) noexcept;
 };
 
-using Hasher = FNVHasher;
+// wyhash-style hasher: 16/48 bytes per step, two 64x64->128 bit multiplies per integer
+struct WyHasher {
+  static constexpr u64 P0 = 0x2d358dccaa6c78a5ULL;
+  static constexpr u64 P1 = 0x8bb84b93962eacc9ULL;
+  static constexpr u64 P2 = 0x4b33a62ed433d4a3ULL;
+  static constexpr u64 P3 = 0x4d5a2da51de1aa47ULL;
+  u64 _state = 0;
+
+ public:
+  auto finish() const noexcept -> u64;
+  void write(slice::Slice<const u8> bytes) noexcept;
+
+  void write_u8(u8 val) noexcept;
+  void write_u16(u16 val) noexcept;
+  void write_u32(u32 val) noexcept;
+  void write_u64(u64 val) noexcept;
+};
+
+// passes integers through unchanged, for keys that already are well-mixed hashes
+struct IdentityHasher {
+  u64 _state = 0;
+
+ public:
+  auto finish() const noexcept -> u64;
+  void write(slice::Slice<const u8> bytes) noexcept;
+
+  void write_u8(u8 val) noexcept;
+  void write_u16(u16 val) noexcept;
+  void write_u32(u32 val) noexcept;
+  void write_u64(u64 val) noexcept;
+};
+
+using Hasher = WyHasher;
 
 struct Hash {
-  template <class T>
+  template <class T, class H = Hasher>
   static auto hash(const T& val) noexcept -> u64 {
-    if constexpr (requires { val.hash(); }) {
+    if constexpr (trait::same_<H, Hasher> && requires { val.hash(); }) {
       return val.hash();
-    } else if constexpr (trait::int_<T>) {
-      auto hasher = Hasher{};
-      hasher.write(mem::as_bytes(val));
+    } else {
+      auto hasher = H{};
+      Hash::write(val, hasher);
       return hasher.finish();
+    }
+  }
+
+  template <class T, class H>
+  static void write(const T& val, H& hasher) noexcept {
+    if constexpr (requires { val.hash(hasher); }) {
+      val.hash(hasher);
+    } else if constexpr (trait::int_<T>) {
+      // native width, so a byte-wise hasher sees the same bytes as `mem::as_bytes(val)`
+      if constexpr (sizeof(T) == 1) {
+        hasher.write_u8(u8(val));
+      } else if constexpr (sizeof(T) == 2) {
+        hasher.write_u16(u16(val));
+      } else if constexpr (sizeof(T) == 4) {
+        hasher.write_u32(u32(val));
+      } else {
+        hasher.write_u64(u64(val));
+      }
+    } else if constexpr (requires { val.hash(); }) {
+      hasher.write_u64(val.hash());
     } else {
-      static_assert(false, "Hash::hash: cannot hash value type");
+      static_assert(false, "Hash::write: cannot hash value type");
     }
   }
 };
 
+// trait: BuildHasher, hashes each key with a fresh `H`
+template <class H = Hasher>
+struct BuildHasher {
+  template <class T>
+  auto hash_one(const T& val) const noexcept -> u64 {
+    return Hash::hash<T, H>(val);
+  }
+};
+
 }  // namespace sfc::hash
 
 namespace sfc {
 using hash::Hash;
 using hash::Hasher;
+using hash::BuildHasher;
 }  // namespace sfc
@@ -87,7 +87,11 @@ struct Str {
 
   constexpr auto eq(Str s) const noexcept -> bool {
     if (_len != s._len) return false;
-    if (_len == 0 || _ptr == s._ptr) return true;
+    if (_len == 0) return true;
+    // addresses of distinct literals do not compare in constant evaluation
+    if !consteval {
+      if (_ptr == s._ptr) return true;
+    }
     return __builtin_memcmp(_ptr, s._ptr, _len) == 0;
   }
 
@@ -146,6 +150,11 @@ struct Str {
 
   // trait: hash::Hash
   auto hash() const noexcept -> usize;
+
+  // trait: hash::Hash
+  void hash(auto& hasher) const noexcept {
+    hasher.write(this->as_bytes());
+  }
 };
 
 template <class T>
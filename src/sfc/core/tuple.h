@@ -105,7 +105,6 @@ struct Tuple : _TupleData<T...> {
 
  public:
   Tuple(T... args) noexcept : Inn{(T&&)(args)...} {}
-  ~Tuple() = default;
 
  public:
   void for_each(auto&& f) const {
@@ -2,3 +2,4 @@
 
 #include "sfc/fs/file.h"
 #include "sfc/fs/path.h"
+#include "sfc/fs/mmap.h"
@@ -0,0 +1,56 @@
+#include "sfc/fs/mmap.h"
+#include "sfc/sys/fs.h"
+
+namespace sfc::fs {
+
+Mmap::Mmap() noexcept = default;
+
+Mmap::~Mmap() noexcept {
+  if (_ptr == nullptr) {
+    return;
+  }
+  sys::munmap(_ptr, _len);
+}
+
+Mmap::Mmap(Mmap&& other) noexcept : _ptr{mem::take(other._ptr)}, _len{mem::take(other._len)} {}
+
+Mmap& Mmap::operator=(Mmap&& other) noexcept {
+  if (this != &other) {
+    mem::swap(_ptr, other._ptr);
+    mem::swap(_len, other._len);
+  }
+  return *this;
+}
+
+auto Mmap::map(const File& file) -> io::Result<Mmap> {
+  const auto meta = _TRY(sys::fstat(file.as_raw_fd()));
+
+  // an empty file cannot be mapped, and needs no mapping
+  auto res = Mmap{};
+  if (meta.file_len() == 0) {
+    return {mem::move(res)};
+  }
+  res._len = usize(meta.file_len());
+  res._ptr = _TRY(sys::mmap(file.as_raw_fd(), res._len));
+  return {mem::move(res)};
+}
+
+auto Mmap::open(Path path) -> io::Result<Mmap> {
+  const auto opts = OpenOptions{.read = true};
+  const auto file = _TRY(opts.open(path));
+  return Mmap::map(file);
+}
+
+auto Mmap::len() const noexcept -> usize {
+  return _len;
+}
+
+auto Mmap::is_empty() const noexcept -> bool {
+  return _len == 0;
+}
+
+auto Mmap::as_bytes() const noexcept -> Slice<const u8> {
+  return {_ptr, _len};
+}
+
+}  // namespace sfc::fs
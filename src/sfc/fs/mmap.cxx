@@ -0,0 +1,28 @@
+#include "sfc/fs.h"
+#include "sfc/env.h"
+#include "sfc/test/test.h"
+
+namespace sfc::fs::test {
+
+SFC_TEST(mmap_read) {
+  const auto path_buf = env::temp_dir().join(Path{"test_mmap.bin"});
+  const auto path = path_buf.as_path();
+  const u8 bytes[] = {1, 2, 3, 4, 5};
+  sfc::assert_eq(fs::write(path, bytes).is_ok(), true);
+
+  {
+    auto map = Mmap::open(path).unwrap();
+    sfc::assert_eq(map.len(), 5U);
+    sfc::assert_eq(map.as_bytes()[4], 5U);
+
+    // the mapping outlives a move
+    const auto other = mem::move(map);
+    sfc::assert_eq(other.as_bytes()[0], 1U);
+  }
+
+  sfc::assert_eq(fs::write(path, {}).is_ok(), true);
+  sfc::assert_eq(Mmap::open(path).unwrap().is_empty(), true);
+  (void)fs::remove_file(path);
+}
+
+}  // namespace sfc::fs::test
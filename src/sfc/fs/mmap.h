@@ -0,0 +1,28 @@
+#pragma once
+
+#include "sfc/fs/file.h"
+
+namespace sfc::fs {
+
+// A whole file mapped read-only into memory. Pages are read in on first touch and shared with
+// every other process mapping the same file; the mapping stays valid after the file is closed.
+class [[nodiscard]] Mmap {
+  const u8* _ptr = nullptr;
+  usize _len = 0;
+
+ public:
+  Mmap() noexcept;
+  ~Mmap() noexcept;
+  Mmap(Mmap&& other) noexcept;
+  Mmap& operator=(Mmap&& other) noexcept;
+
+  static auto map(const File& file) -> io::Result<Mmap>;
+  static auto open(Path path) -> io::Result<Mmap>;
+
+ public:
+  auto len() const noexcept -> usize;
+  auto is_empty() const noexcept -> bool;
+  auto as_bytes() const noexcept -> Slice<const u8>;
+};
+
+}  // namespace sfc::fs
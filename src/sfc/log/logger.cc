@@ -1,7 +1,24 @@
 #include "sfc/log/logger.h"
+#include "sfc/collections/hash/static_map.h"
 
 namespace sfc::log {
 
+static constexpr auto kLevelNames = collections::static_map<Str, Level>({
+    {"trace", Level::Trace},
+    {"debug", Level::Debug},
+    {"info", Level::Info},
+    {"warn", Level::Warn},
+    {"error", Level::Error},
+    {"fatal", Level::Fatal},
+});
+
+auto level_from_str(Str name) -> Option<Level> {
+  if (auto level = kLevelNames.get(name)) {
+    return *level;
+  }
+  return {};
+}
+
 auto Logger::level() const -> Level {
   return _level;
 }
@@ -15,4 +15,10 @@ SFC_TEST(log_funcs) {
   log::fatal("log {}", 6);
 }
 
+SFC_TEST(log_level_from_str) {
+  sfc::assert_eq(log::level_from_str("warn") == Option{log::Level::Warn}, true);
+  sfc::assert_eq(log::level_from_str("fatal") == Option{log::Level::Fatal}, true);
+  sfc::assert_eq(log::level_from_str("WARN").is_none(), true);
+}
+
 }  // namespace sfc::log::test
@@ -7,6 +7,9 @@ namespace sfc::log {
 
 enum class Level { Trace, Debug, Info, Warn, Error, Fatal };
 
+// parse a level name such as "info" (as used in configs and env vars)
+auto level_from_str(Str name) -> Option<Level>;
+
 struct Record {
   time::SystemTime _time;
   Level _level;
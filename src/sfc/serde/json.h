@@ -168,7 +168,7 @@ class Deserializer {
     } else if constexpr (trait::float_<T>) {
       return this->deserialize_f64().map([](f64 v) { return T(v); });
     } else if constexpr (requires { T{Str{}}; }) {
-      return this->deserialize_str().and_then([](Str s) { return T{s}; });
+      return this->deserialize_str().map([](Str s) { return T{s}; });
     } else {
       static_assert(false, "json::Deserializer::deserialize: not deserializable");
     }
@@ -206,9 +206,13 @@ class DeserializeSeq {
       if (!opt) {
         break;
       }
-      seq.push(mem::move(opt).unwrap());
+      if constexpr (requires { seq.push(mem::move(opt).unwrap()); }) {
+        seq.push(mem::move(opt).unwrap());
+      } else {
+        seq.insert(mem::move(opt).unwrap());
+      }
     }
-    return {seq};
+    return {mem::move(seq)};
   }
 };
 
@@ -238,9 +242,13 @@ class DeserializeObj {
         break;
       }
       auto val = _TRY(this->next_val<V>());
-      obj.insert(key, mem::move(val));
+      if constexpr (requires { K::from(*key); }) {
+        obj.insert(K::from(*key), mem::move(val));
+      } else {
+        obj.insert(K{*key}, mem::move(val));
+      }
     }
-    return {obj};
+    return {mem::move(obj)};
   }
 };
 
@@ -2,4 +2,5 @@
 
 #include "sfc/sync/arc.h"
 #include "sfc/sync/mutex.h"
+#include "sfc/sync/rwlock.h"
 #include "sfc/sync/condvar.h"
@@ -48,4 +48,17 @@ SFC_TEST(clone) {
   sfc::assert_eq(cnt, 0);
 }
 
+SFC_TEST(get_mut) {
+  auto ra = Arc<int>::new_(1);
+  ra.get_mut().unwrap() += 1;
+  sfc::assert_eq(*ra, 2);
+
+  {
+    const auto rb = ra.clone();
+    sfc::assert_eq(ra.get_mut().is_none(), true);
+  }
+  sfc::assert_eq(ra.get_mut().is_some(), true);
+  sfc::assert_eq(Arc<int>{}.get_mut().is_none(), true);
+}
+
 }  // namespace sfc::sync::test
@@ -14,8 +14,10 @@ class [[nodiscard]] Arc {
       return _cnt.fetch_add(1, sync::Ordering::Relaxed);
     }
 
+    // acquire too, so the thread that drops the last reference sees every write made
+    // through the others before it deletes the value
     auto dec_count() noexcept -> u32 {
-      return _cnt.fetch_sub(1, sync::Ordering::Release);
+      return _cnt.fetch_sub(1, sync::Ordering::AcqRel);
     }
   };
   Inn* _ptr{nullptr};
@@ -49,6 +51,14 @@ class [[nodiscard]] Arc {
     return _ptr ? &_ptr->_val : nullptr;
   }
 
+  // the value, if no other Arc shares it, so that it can be changed in place
+  auto get_mut() noexcept -> Option<T&> {
+    if (_ptr == nullptr || _ptr->_cnt.load(sync::Ordering::Acquire) != 1) {
+      return {};
+    }
+    return _ptr->_val;
+  }
+
  public:
   // trait: Deref<const T*>
   auto operator->() const noexcept -> const T* {
@@ -0,0 +1,85 @@
+#include "sfc/sync/rwlock.h"
+
+namespace sfc::sync {
+
+RwLock::RwLock() noexcept : _inn{} {}
+
+RwLock::~RwLock() noexcept {}
+
+RwLock::RwLock(RwLock&& other) noexcept : _inn{mem::move(other._inn)} {}
+
+RwLock& RwLock::operator=(RwLock&& other) noexcept = default;
+
+auto RwLock::read() noexcept -> ReadGuard {
+  _inn.read_lock();
+
+  auto res = ReadGuard{};
+  res._lock = this;
+  return res;
+}
+
+auto RwLock::try_read() noexcept -> Option<ReadGuard> {
+  if (!_inn.try_read_lock()) {
+    return {};
+  }
+
+  auto res = ReadGuard{};
+  res._lock = this;
+  return res;
+}
+
+auto RwLock::write() noexcept -> WriteGuard {
+  _inn.write_lock();
+
+  auto res = WriteGuard{};
+  res._lock = this;
+  return res;
+}
+
+auto RwLock::try_write() noexcept -> Option<WriteGuard> {
+  if (!_inn.try_write_lock()) {
+    return {};
+  }
+
+  auto res = WriteGuard{};
+  res._lock = this;
+  return res;
+}
+
+RwLock::ReadGuard::ReadGuard() noexcept : _lock{nullptr} {}
+
+RwLock::ReadGuard::~ReadGuard() noexcept {
+  if (_lock == nullptr) return;
+  _lock->_inn.read_unlock();
+}
+
+RwLock::ReadGuard::ReadGuard(ReadGuard&& other) noexcept : _lock{other._lock} {
+  other._lock = nullptr;
+}
+
+RwLock::ReadGuard& RwLock::ReadGuard::operator=(ReadGuard&& other) noexcept {
+  if (this != &other) {
+    mem::swap(_lock, other._lock);
+  }
+  return *this;
+}
+
+RwLock::WriteGuard::WriteGuard() noexcept : _lock{nullptr} {}
+
+RwLock::WriteGuard::~WriteGuard() noexcept {
+  if (_lock == nullptr) return;
+  _lock->_inn.write_unlock();
+}
+
+RwLock::WriteGuard::WriteGuard(WriteGuard&& other) noexcept : _lock{other._lock} {
+  other._lock = nullptr;
+}
+
+RwLock::WriteGuard& RwLock::WriteGuard::operator=(WriteGuard&& other) noexcept {
+  if (this != &other) {
+    mem::swap(_lock, other._lock);
+  }
+  return *this;
+}
+
+}  // namespace sfc::sync
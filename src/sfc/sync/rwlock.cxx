@@ -0,0 +1,56 @@
+#include "sfc/test/test.h"
+#include "sfc/thread.h"
+#include "sfc/sync/rwlock.h"
+
+namespace sfc::sync::test {
+
+SFC_TEST(rwlock_shared_read) {
+  auto lock = RwLock{};
+
+  auto r1 = lock.read();
+  auto r2 = lock.try_read();
+  sfc::assert_eq(r2.is_some(), true);
+  sfc::assert_eq(lock.try_write().is_some(), false);
+}
+
+SFC_TEST(rwlock_exclusive_write) {
+  auto lock = RwLock{};
+
+  {
+    auto w = lock.write();
+    sfc::assert_eq(lock.try_read().is_some(), false);
+    sfc::assert_eq(lock.try_write().is_some(), false);
+  }
+  sfc::assert_eq(lock.try_write().is_some(), true);
+}
+
+SFC_TEST(rwlock_threads) {
+  static constexpr auto CNT = 1000U;
+  auto lock = RwLock{};
+  auto a = 0U;
+  auto b = 0U;
+
+  auto writer = [&]() {
+    for (auto i = 0U; i < CNT; ++i) {
+      auto w = lock.write();
+      a += 1;
+      b += 1;
+    }
+  };
+  auto reader = [&]() {
+    for (auto i = 0U; i < CNT; ++i) {
+      auto r = lock.read();
+      sfc::assert_eq(a, b);
+    }
+  };
+
+  {
+    auto t1 = thread::spawn_joined(writer);
+    auto t2 = thread::spawn_joined(reader);
+    auto t3 = thread::spawn_joined(writer);
+    auto t4 = thread::spawn_joined(reader);
+  }
+  sfc::assert_eq(a, 2 * CNT);
+}
+
+}  // namespace sfc::sync::test
@@ -0,0 +1,51 @@
+#pragma once
+
+#include "sfc/core.h"
+#include "sfc/sys/sync.h"
+
+namespace sfc::sync {
+
+// any number of readers, or a single writer
+class RwLock {
+  using Inn = sys::RwLock;
+  Inn _inn;
+
+ public:
+  explicit RwLock() noexcept;
+  ~RwLock() noexcept;
+  RwLock(RwLock&& other) noexcept;
+  RwLock& operator=(RwLock&&) noexcept;
+
+ public:
+  class ReadGuard;
+  auto read() noexcept -> ReadGuard;
+  auto try_read() noexcept -> Option<ReadGuard>;
+
+  class WriteGuard;
+  auto write() noexcept -> WriteGuard;
+  auto try_write() noexcept -> Option<WriteGuard>;
+};
+
+class RwLock::ReadGuard {
+  friend class RwLock;
+  RwLock* _lock{nullptr};
+
+ public:
+  ReadGuard() noexcept;
+  ~ReadGuard() noexcept;
+  ReadGuard(ReadGuard&&) noexcept;
+  ReadGuard& operator=(ReadGuard&&) noexcept;
+};
+
+class RwLock::WriteGuard {
+  friend class RwLock;
+  RwLock* _lock{nullptr};
+
+ public:
+  WriteGuard() noexcept;
+  ~WriteGuard() noexcept;
+  WriteGuard(WriteGuard&&) noexcept;
+  WriteGuard& operator=(WriteGuard&&) noexcept;
+};
+
+}  // namespace sfc::sync
@@ -1,6 +1,7 @@
 #include <fcntl.h>
 #include <stdio.h>
 #include <unistd.h>
+#include <sys/mman.h>
 #include <sys/stat.h>
 
 #include "sfc/fs/file.h"
@@ -87,4 +88,16 @@ auto rmdir(const char* path) -> io::Result<> {
   return Ok{};
 }
 
+auto mmap(RawFd fd, usize len) -> io::Result<const u8*> {
+  const auto ptr = ::mmap(nullptr, len, PROT_READ, MAP_SHARED, fd, 0);
+  if (ptr == MAP_FAILED) {
+    return io::last_os_error();
+  }
+  return Ok{static_cast<const u8*>(ptr)};
+}
+
+void munmap(const u8* ptr, usize len) {
+  ::munmap(const_cast<u8*>(ptr), len);
+}
+
 }  // namespace sfc::sys::posix
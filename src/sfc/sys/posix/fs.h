@@ -29,4 +29,8 @@ auto rename(const char* old_path, const char* new_path) -> io::Result<>;
 auto mkdir(const char* path) -> io::Result<>;
 auto rmdir(const char* path) -> io::Result<>;
 
+// read-only, shared mapping of the first `len` bytes of a file
+auto mmap(RawFd fd, usize len) -> io::Result<const u8*>;
+void munmap(const u8* ptr, usize len);
+
 }  // namespace sfc::sys::posix
@@ -62,6 +62,79 @@ auto Mutex::try_lock() -> bool {
   return err == 0;
 }
 
+struct RwLock::Inn {
+  pthread_rwlock_t _0;
+
+ public:
+  Inn() {
+    auto attr = pthread_rwlockattr_t{};
+    (void)::pthread_rwlockattr_init(&attr);
+#ifdef __GLIBC__
+    // glibc prefers readers by default, which can starve writers under a steady read load
+    (void)::pthread_rwlockattr_setkind_np(&attr, PTHREAD_RWLOCK_PREFER_WRITER_NONRECURSIVE_NP);
+#endif
+    (void)::pthread_rwlock_init(&_0, &attr);
+    (void)::pthread_rwlockattr_destroy(&attr);
+  }
+
+  ~Inn() {
+    (void)::pthread_rwlock_destroy(&_0);
+  }
+
+  Inn(const Inn&) = delete;
+  Inn& operator=(const Inn&) = delete;
+};
+
+RwLock::RwLock() {
+  _ptr = new Inn{};
+}
+
+RwLock::~RwLock() {
+  if (_ptr == nullptr) return;
+  delete _ptr;
+}
+
+RwLock::RwLock(RwLock&& other) noexcept : _ptr{mem::take(other._ptr)} {}
+
+RwLock& RwLock::operator=(RwLock&& other) noexcept {
+  if (this != &other) {
+    mem::swap(_ptr, other._ptr);
+  }
+  return *this;
+}
+
+void RwLock::read_lock() {
+  const auto err = ::pthread_rwlock_rdlock(&_ptr->_0);
+  sfc::assert_(err == 0, "sync::RwLock::read_lock: failed, err={}", err);
+}
+
+void RwLock::read_unlock() {
+  const auto err = ::pthread_rwlock_unlock(&_ptr->_0);
+  sfc::assert_(err == 0, "sync::RwLock::read_unlock: failed, err={}", err);
+}
+
+auto RwLock::try_read_lock() -> bool {
+  const auto err = ::pthread_rwlock_tryrdlock(&_ptr->_0);
+  sfc::assert_(err == 0 || err == EBUSY, "sync::RwLock::try_read_lock: failed, err={}", err);
+  return err == 0;
+}
+
+void RwLock::write_lock() {
+  const auto err = ::pthread_rwlock_wrlock(&_ptr->_0);
+  sfc::assert_(err == 0, "sync::RwLock::write_lock: failed, err={}", err);
+}
+
+void RwLock::write_unlock() {
+  const auto err = ::pthread_rwlock_unlock(&_ptr->_0);
+  sfc::assert_(err == 0, "sync::RwLock::write_unlock: failed, err={}", err);
+}
+
+auto RwLock::try_write_lock() -> bool {
+  const auto err = ::pthread_rwlock_trywrlock(&_ptr->_0);
+  sfc::assert_(err == 0 || err == EBUSY, "sync::RwLock::try_write_lock: failed, err={}", err);
+  return err == 0;
+}
+
 struct CondvarAttr {
   pthread_condattr_t _0;
 
@@ -22,6 +22,27 @@ class Mutex {
   auto try_lock() -> bool;
 };
 
+class RwLock {
+  struct Inn;
+  Inn* _ptr{nullptr};
+
+ public:
+  explicit RwLock();
+  ~RwLock();
+
+  RwLock(RwLock&& other) noexcept;
+  RwLock& operator=(RwLock&& other) noexcept;
+
+ public:
+  void read_lock();
+  void read_unlock();
+  auto try_read_lock() -> bool;
+
+  void write_lock();
+  void write_unlock();
+  auto try_write_lock() -> bool;
+};
+
 class Condvar {
   struct Inn;
   Inn* _ptr;
@@ -85,4 +85,24 @@ auto rmdir(const wchar_t* path) -> io::Result<> {
   return Ok{};
 }
 
+auto mmap(void* fd, usize len) -> io::Result<const u8*> {
+  const auto mapping = ::CreateFileMappingW(fd, nullptr, PAGE_READONLY, 0, 0, nullptr);
+  if (mapping == nullptr) {
+    return io::last_os_error();
+  }
+
+  // the view keeps the mapping alive after its handle is closed
+  const auto view = ::MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, len);
+  const auto err = view == nullptr ? io::last_os_error() : io::Error::Success;
+  ::CloseHandle(mapping);
+  if (view == nullptr) {
+    return err;
+  }
+  return Ok{static_cast<const u8*>(view)};
+}
+
+void munmap(const u8* ptr, usize) {
+  ::UnmapViewOfFile(ptr);
+}
+
 }  // namespace sfc::sys::windows
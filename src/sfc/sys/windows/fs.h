@@ -29,4 +29,8 @@ auto rename(const wchar_t* old_path, const wchar_t* new_path) -> io::Result<>;
 auto mkdir(const wchar_t* path) -> io::Result<>;
 auto rmdir(const wchar_t* path) -> io::Result<>;
 
+// read-only, shared mapping of the first `len` bytes of a file
+auto mmap(void* fd, usize len) -> io::Result<const u8*>;
+void munmap(const u8* ptr, usize len);
+
 }  // namespace sfc::sys::windows
@@ -46,6 +46,57 @@ auto Mutex::try_lock() -> bool {
   return bool(ret);
 }
 
+struct RwLock::Inn {
+  SRWLOCK _0;
+};
+
+RwLock::RwLock() {
+  _ptr = new Inn{};
+  ::InitializeSRWLock(&_ptr->_0);
+}
+
+RwLock::~RwLock() {
+  if (_ptr == nullptr) return;
+  delete _ptr;
+}
+
+RwLock::RwLock(RwLock&& other) noexcept : _ptr{other._ptr} {
+  other._ptr = nullptr;
+}
+
+RwLock& RwLock::operator=(RwLock&& other) noexcept {
+  if (this != &other) {
+    mem::swap(_ptr, other._ptr);
+  }
+  return *this;
+}
+
+void RwLock::read_lock() {
+  ::AcquireSRWLockShared(&_ptr->_0);
+}
+
+void RwLock::read_unlock() {
+  ::ReleaseSRWLockShared(&_ptr->_0);
+}
+
+auto RwLock::try_read_lock() -> bool {
+  const auto ret = ::TryAcquireSRWLockShared(&_ptr->_0);
+  return bool(ret);
+}
+
+void RwLock::write_lock() {
+  ::AcquireSRWLockExclusive(&_ptr->_0);
+}
+
+void RwLock::write_unlock() {
+  ::ReleaseSRWLockExclusive(&_ptr->_0);
+}
+
+auto RwLock::try_write_lock() -> bool {
+  const auto ret = ::TryAcquireSRWLockExclusive(&_ptr->_0);
+  return bool(ret);
+}
+
 struct Condvar::Inn {
   CONDITION_VARIABLE _0;
 };
@@ -0,0 +1,126 @@
+#include <sfc/io.h>
+#include <sfc/time.h>
+#include <sfc/test.h>
+#include <sfc/collections.h>
+
+using namespace sfc;
+
+static constexpr auto kCount = 1U << 20;
+static constexpr auto kLoop = 16U;
+
+static auto key_at(u64 i) -> u64 {
+  return i * 0x9E3779B97F4A7C15ULL;
+}
+
+// the byte-at-a-time linear probe the table used before group matching
+struct ScalarTbl {
+  struct Entry {
+    u64 key;
+    u64 val;
+  };
+  List<u8> _ctrl;
+  List<Entry> _data;
+  usize _mask;
+
+ public:
+  explicit ScalarTbl(usize cap) : _mask{cap - 1} {
+    _ctrl.resize(cap, 0x80U);
+    _data.resize(cap, Entry{0, 0});
+  }
+
+  void insert(u64 key, u64 val) {
+    const auto hx = Hash::hash(key);
+    const auto h2 = u8((hx >> 57) & 0x7F);
+    for (auto i = 0UL; i <= _mask; ++i) {
+      const auto k = (hx + i) & _mask;
+      if (_ctrl[k] == 0x80U) {
+        _ctrl[k] = h2;
+        _data[k] = {key, val};
+        return;
+      }
+      if (_ctrl[k] == h2 && _data[k].key == key) {
+        _data[k].val = val;
+        return;
+      }
+    }
+  }
+
+  auto get(u64 key) const -> const u64* {
+    const auto hx = Hash::hash(key);
+    const auto h2 = u8((hx >> 57) & 0x7F);
+    for (auto i = 0UL; i <= _mask; ++i) {
+      const auto k = (hx + i) & _mask;
+      const auto c = _ctrl[k];
+      if (c == h2 && _data[k].key == key) {
+        return &_data[k].val;
+      } else if (c == 0x80U) {
+        return nullptr;
+      }
+    }
+    return nullptr;
+  }
+};
+
+SFC_TEST(scalar_probe) {
+  auto tbl = ScalarTbl{kCount * 2};
+
+  auto timer = time::Instant::now();
+  for (auto i = 0U; i < kCount; ++i) {
+    tbl.insert(key_at(i), i);
+  }
+  io::println("scalar insert: {} ms", timer.elapsed().as_millis());
+
+  timer = time::Instant::now();
+  auto hits = 0UL;
+  for (auto loop = 0U; loop < kLoop; ++loop) {
+    for (auto i = 0U; i < kCount; ++i) {
+      hits += tbl.get(key_at(i + loop)) != nullptr;
+    }
+  }
+  io::println("scalar lookup: {} ms, hits = {}", timer.elapsed().as_millis(), hits);
+}
+
+SFC_TEST(group_probe) {
+  // the same 2^21 slots as the scalar table, so no resize lands in the timed inserts
+  auto tbl = collections::HashMap<u64, u64>::with_capacity(kCount);
+  sfc::assert_eq(tbl.capacity(), kCount * 2);
+
+  auto timer = time::Instant::now();
+  for (auto i = 0U; i < kCount; ++i) {
+    tbl.insert(key_at(i), i);
+  }
+  io::println("group insert: {} ms", timer.elapsed().as_millis());
+
+  timer = time::Instant::now();
+  auto hits = 0UL;
+  for (auto loop = 0U; loop < kLoop; ++loop) {
+    for (auto i = 0U; i < kCount; ++i) {
+      hits += tbl.contains_key(key_at(i + loop));
+    }
+  }
+  io::println("group lookup: {} ms, hits = {}", timer.elapsed().as_millis(), hits);
+}
+
+static void insert_tail(const char* name, bool incremental) {
+  auto tbl = collections::HashMap<u64, u64>{};
+  tbl.set_incremental_resize(incremental);
+
+  auto total = time::Instant::now();
+  auto worst = 0UL;
+  for (auto i = 0U; i < kCount; ++i) {
+    const auto timer = time::Instant::now();
+    tbl.insert(key_at(i), i);
+    worst = cmp::max(worst, timer.elapsed().as_micros());
+  }
+  io::println("{} insert: {} ms, worst = {} us", name, total.elapsed().as_millis(), worst);
+}
+
+SFC_TEST(resize_tail) {
+  insert_tail("bulk resize", false);
+  insert_tail("incremental resize", true);
+}
+
+int main(int argc, const char* argv[]) {
+  test::main(argc, argv);
+  return 0;
+}
@@ -0,0 +1,64 @@
+#include <sfc/io.h>
+#include <sfc/time.h>
+#include <sfc/test.h>
+#include <sfc/collections.h>
+
+using namespace sfc;
+
+static constexpr auto kCount = 1U << 18;
+static constexpr auto kLoop = 16U;
+
+// path-like keys: long shared prefixes, short distinct tails
+static auto make_keys() -> List<String> {
+  auto keys = List<String>{};
+  keys.reserve(kCount);
+  for (auto i = 0U; i < kCount; ++i) {
+    keys.push(string::format("/usr/share/app/{}/{}/{}.dat", i % 16, (i / 16) % 64, i));
+  }
+  return keys;
+}
+
+SFC_TEST(radix_map) {
+  const auto keys = make_keys();
+  auto map = collections::RadixMap<u32>{};
+
+  auto timer = time::Instant::now();
+  for (auto i = 0U; i < kCount; ++i) {
+    map.insert(keys[i].as_str(), i);
+  }
+  io::println("radix insert: {} ms", timer.elapsed().as_millis());
+
+  timer = time::Instant::now();
+  auto hits = 0UL;
+  for (auto loop = 0U; loop < kLoop; ++loop) {
+    for (auto i = 0U; i < kCount; ++i) {
+      hits += map.contains_key(keys[(i + loop) % kCount].as_str());
+    }
+  }
+  io::println("radix lookup: {} ms, hits = {}", timer.elapsed().as_millis(), hits);
+}
+
+SFC_TEST(hash_map) {
+  const auto keys = make_keys();
+  auto map = collections::HashMap<String, u32>{};
+
+  auto timer = time::Instant::now();
+  for (auto i = 0U; i < kCount; ++i) {
+    map.insert(String::from(keys[i].as_str()), i);
+  }
+  io::println("hash insert: {} ms", timer.elapsed().as_millis());
+
+  timer = time::Instant::now();
+  auto hits = 0UL;
+  for (auto loop = 0U; loop < kLoop; ++loop) {
+    for (auto i = 0U; i < kCount; ++i) {
+      hits += map.contains_key(keys[(i + loop) % kCount].as_str());
+    }
+  }
+  io::println("hash lookup: {} ms, hits = {}", timer.elapsed().as_millis(), hits);
+}
+
+int main(int argc, const char* argv[]) {
+  test::main(argc, argv);
+  return 0;
+}